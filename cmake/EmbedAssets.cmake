@@ -0,0 +1,41 @@
+# Writes a C++ source that holds files as byte arrays (see include/EmbeddedAssets.h).
+#
+#   cmake -DOUTPUT=<file.cpp> -DNAMES=<name;...> -DFILES=<path;...> -P EmbedAssets.cmake
+#
+# NAMES[i] becomes a 'const EmbeddedAsset' holding the bytes of FILES[i]. The output is only
+# rewritten when its content changes, so an unchanged asset does not trigger a rebuild.
+list(LENGTH NAMES count)
+list(LENGTH FILES fileCount)
+if(NOT count EQUAL fileCount OR count EQUAL 0)
+    message(FATAL_ERROR "EmbedAssets: NAMES and FILES must be non-empty and of the same length")
+endif()
+
+set(source "// Generated by cmake/EmbedAssets.cmake; do not edit.\n#include \"EmbeddedAssets.h\"\n")
+set(row "")
+foreach(column RANGE 15)
+    string(APPEND row "0x[0-9a-f][0-9a-f],")
+endforeach()
+math(EXPR last "${count} - 1")
+foreach(i RANGE ${last})
+    list(GET NAMES ${i} name)
+    list(GET FILES ${i} path)
+    file(READ "${path}" hex HEX)
+    string(LENGTH "${hex}" digits)
+    math(EXPR bytes "${digits} / 2")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," hex "${hex}")
+    # 16 bytes per line. CMake regexes have no {n} repetition, so the row is spelled out.
+    string(REGEX REPLACE "(${row})" "\\1\n    " hex "${hex}")
+    string(REGEX REPLACE "\n    $" "" hex "${hex}")
+    get_filename_component(file "${path}" NAME)
+    string(APPEND source
+        "\n// ${file}, ${bytes} bytes\n"
+        "static const unsigned char ${name}_BYTES[] = {\n    ${hex}\n};\n"
+        "const EmbeddedAsset ${name} = {${name}_BYTES, ${bytes}};\n")
+endforeach()
+
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+endif()
+if(NOT previous STREQUAL source)
+    file(WRITE "${OUTPUT}" "${source}")
+endif()
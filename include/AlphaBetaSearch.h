@@ -0,0 +1,161 @@
+// AlphaBetaSearch.h
+#ifndef ALPHABETASEARCH_H
+#define ALPHABETASEARCH_H
+
+#include "HexBoard.h"
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Scores are for the side to move, in the shape of HexSolver's: ALPHABETA_WIN_SCORE - n is a
+// win on the n-th ply from the root, and anything within ALPHABETA_WIN_THRESHOLD is a
+// heuristic evaluation.
+const int ALPHABETA_WIN_SCORE = 1000000000;
+const int ALPHABETA_WIN_THRESHOLD = ALPHABETA_WIN_SCORE - 100000;
+
+struct AlphaBetaResult {
+    int score;              // For the side to move
+    int bestMove;           // Cell index, or -1 if the search was stopped before it had one
+    std::uint64_t nodes;
+};
+
+// Depth-limited negamax with alpha-beta pruning, for positions too large to solve. Leaves are
+// scored by their open lines: a k-in-a-row that holds n marks of one player and none of the
+// other is worth 8^(n - 1) to that player. The search keeps its own copy of the position
+// (cell values and per-line mark counts) and updates it incrementally, so a move costs O(k)
+// whatever board type it was loaded from. Moves are tried in order of how much they change
+// the evaluation (attack and defence), centre first on ties; on boards wider than
+// FULL_WIDTH_CELLS only cells within two steps of a mark are considered.
+//
+// With a transposition table (tableBits > 0, 2^tableBits entries of 16 bytes) positions are
+// keyed by a Zobrist hash kept up to date by play() and undo(). The table outlives searches
+// and positions: after play(), a search starts from whatever earlier searches of the
+// previous position stored below it, and its best stored move is tried first.
+class AlphaBetaSearch {
+public:
+    static const int FULL_WIDTH_CELLS = 61;  // Radius 4
+
+    template <class Board>
+    explicit AlphaBetaSearch(const Board& prototype, int tableBits = 0);
+
+    template <class Board>
+    void setPosition(const Board& board) {
+        clear();
+        for (int cell = 0; cell < cells; cell++) {
+            char mark = board.valueAt(cell);
+            if (mark != ' ')
+                play(cell, mark);
+        }
+    }
+    // Applies a move to the loaded position, so a game can be followed without reloading it.
+    void play(int cell, char player);
+    void undo(int cell, char player);
+
+    // Best move for 'player', searching 'depth' plies (at least 1).
+    AlphaBetaResult search(char player, int depth);
+    // Value for 'player' of playing 'cell' (which must be empty), with depth - 1 plies searched
+    // below it in a full window. Used where every move needs a score, not only the best one.
+    int scoreMove(char player, int cell, int depth);
+    // Static evaluation of the loaded position for 'player'.
+    int evaluate(char player) const;
+
+    // A running search polls 'flag' and returns early, with stopped() set, once it is true.
+    void setStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+    bool stopped() const { return halted; }
+    // Nodes visited since the search object was created.
+    std::uint64_t nodeCount() const { return nodes; }
+
+    int cellCount() const { return cells; }
+    char valueAt(int cell) const { return values[cell]; }
+    int moveCount() const { return placed; }
+
+private:
+    struct Candidate {
+        int cell;
+        long long order;
+    };
+
+    // Buckets of two: the first entry keeps the deepest result, the second the latest.
+    struct TableEntry {
+        std::uint64_t key;
+        std::int32_t score;
+        std::int16_t move;
+        std::uint8_t bound;
+        std::uint8_t depth;
+    };
+
+    void build(const std::vector<int>& lineCells, const std::vector<std::vector<int>>& near, int tableBits);
+    void clear();
+    long long lineScore(int line) const;
+    // Fills 'moves' for 'player', best first. Returns a cell that wins on the spot, or -1.
+    int generate(char player, std::vector<Candidate>& moves) const;
+    int negamax(char player, int depth, int alpha, int beta, int ply, int* bestMoveOut);
+    std::uint64_t keyFor(char player) const { return player == 'O' ? hash ^ sideKey : hash; }
+    const TableEntry* probe(std::uint64_t key) const;
+    void store(std::uint64_t key, int score, int move, TTBound bound, int depth);
+
+    int cells;
+    int k;
+    std::vector<long long> weights;       // weights[n]: an open line with n marks
+    std::vector<int> cellLineStart;       // Lines through cell c: cellLines[cellLineStart[c] .. cellLineStart[c + 1])
+    std::vector<int> cellLines;
+    std::vector<int> nearStart;           // Cells within two steps of c, same layout as cellLines
+    std::vector<int> nearCells;
+    std::vector<int> centreDistance;
+
+    std::vector<char> values;             // ' ', 'X' or 'O' per cell
+    std::vector<int> xCount;              // Marks per line
+    std::vector<int> oCount;
+    std::vector<int> nearCount;           // Marks within two steps of each cell
+    int threats[2];                       // Lines one mark short of a win, open, per player (X, O)
+    long long xScore;                     // Evaluation for X
+    int placed;
+    std::uint64_t hash;                   // Zobrist hash of the marks
+
+    std::vector<std::uint64_t> zobrist;   // zobrist[cell] for 'X', zobrist[cells + cell] for 'O'
+    std::uint64_t sideKey;                // Toggled into the key when 'O' is to move
+    std::vector<TableEntry> table;        // Empty without a transposition table
+    std::uint64_t tableMask;
+
+    std::vector<std::vector<Candidate>> moveBuffers;  // One per ply
+    const std::atomic<bool>* stopFlag;
+    bool halted;
+    std::uint64_t nodes;
+};
+
+template <class Board>
+AlphaBetaSearch::AlphaBetaSearch(const Board& prototype, int tableBits)
+    : cells(prototype.cellCount()), k(prototype.winLength()), stopFlag(nullptr), halted(false), nodes(0) {
+    // Every k-in-a-row, as the cells along an axis from each starting cell. With k = 1 the
+    // three axes would give the same one-cell line three times.
+    std::vector<int> lineCells;
+    std::vector<std::vector<int>> near(cells);
+    for (int cell = 0; cell < cells; cell++) {
+        HexCell c = prototype.cellAt(cell);
+        for (int axis = 0; axis < (k > 1 ? 3 : 1); axis++) {
+            std::size_t start = lineCells.size();
+            for (int i = 0; i < k; i++) {
+                int next = prototype.cellIndex(c.q + i * HEX_DIRECTIONS[axis][0], c.r + i * HEX_DIRECTIONS[axis][1]);
+                if (next < 0) {
+                    lineCells.resize(start);
+                    break;
+                }
+                lineCells.push_back(next);
+            }
+        }
+        for (int dq = -2; dq <= 2; dq++) {
+            for (int dr = std::max(-2, -dq - 2); dr <= std::min(2, -dq + 2); dr++) {
+                int other = (dq || dr) ? prototype.cellIndex(c.q + dq, c.r + dr) : -1;
+                if (other >= 0)
+                    near[cell].push_back(other);
+            }
+        }
+        centreDistance.push_back(std::max(std::abs(c.q), std::max(std::abs(c.r), std::abs(c.q + c.r))));
+    }
+    build(lineCells, near, tableBits);
+}
+
+#endif
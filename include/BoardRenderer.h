@@ -0,0 +1,101 @@
+// BoardRenderer.h
+#ifndef BOARDRENDERER_H
+#define BOARDRENDERER_H
+
+#include "HexBoard.h"
+#include "HexGraphics.h"
+#include "PositionAnalyzer.h"
+#include "UI.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Retained renderer for the board. All hexagon fills and outlines live in one vertex array
+// (fills first, then outlines, so borders are never covered by a neighbouring fill) and are
+// drawn with a single draw call. Geometry is built in board coordinates once per layout; the
+// on-screen offset is the Transformable position, so moving the board does not touch the
+// vertices, and a move only rewrites the colors of the cell that changed.
+class BoardRenderer : public sf::Drawable, public sf::Transformable {
+public:
+    static const int FILL_VERTICES_PER_CELL = 6 * 3;      // One triangle per hexagon side
+    static const int OUTLINE_VERTICES_PER_CELL = 6 * 6;   // One quad (two triangles) per side
+
+    BoardRenderer();
+
+    // Rebuilds the geometry for every cell of 'board' and colors it to match.
+    template <class Board>
+    void build(const Board& board) {
+        beginBuild(board.cellCount());
+        for (const auto &cell : board.getCells())
+            addCell(cell);
+        endBuild();
+    }
+
+    // Rewrites the fill colors of one cell.
+    void setCellValue(int index, char value);
+    // Highlights one cell (or none, with -1). Only the previous and new cell are recolored.
+    void setHoveredCell(int index);
+    int getHoveredCell() const { return hoveredCell; }
+
+    // Brings every cell's color in line with 'board', touching only cells that differ.
+    template <class Board>
+    void sync(const Board& board) {
+        for (int i = 0; i < board.cellCount(); i++) {
+            char value = board.valueAt(i);
+            if (value != values[i])
+                setCellValue(i, value);
+        }
+    }
+
+    std::size_t vertexCount() const { return vertices.getVertexCount(); }
+
+private:
+    void beginBuild(int cellCount);
+    void addCell(const HexCell& cell);
+    void endBuild();
+    sf::Color fillColorFor(int index, char value) const;
+    void writeFill(int index);
+
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+    sf::VertexArray vertices;
+    std::vector<sf::Vertex> outlines;  // Staging area while building
+    std::vector<char> values;          // Value each cell is currently colored for
+    int hoveredCell;                   // Highlighted cell, or -1
+};
+
+// Analysis mode's heat map, drawn over a BoardRenderer with the same position. Each scored
+// empty cell gets a translucent hexagon, red where the side to move loses through yellow to
+// green where it wins, and a label: the win probability in percent, or W or L and the number
+// of plies for a proven result ("=" for a proven draw). Built in board coordinates like the
+// board; update() only recolors the cells whose score changed and re-lays out their labels.
+class AnalysisOverlay : public sf::Drawable, public sf::Transformable {
+public:
+    AnalysisOverlay();
+
+    template <class Board>
+    void build(const Board& board) {
+        beginBuild(board.cellCount(), board.winLength());
+        for (const auto &cell : board.getCells())
+            addCell(cell);
+    }
+
+    // Shows the scores of 'snapshot' (for the board the overlay was built for).
+    void update(const AnalysisSnapshot& snapshot);
+    // Hides every cell.
+    void clear();
+
+private:
+    void beginBuild(int cellCount, int winLength);
+    void addCell(const HexCell& cell);
+    void setCell(int index, int score, bool exact);
+
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+    sf::VertexArray vertices;       // BoardRenderer::FILL_VERTICES_PER_CELL per cell
+    std::vector<TextLabel> labels;
+    std::vector<int> shownScores;   // Score each cell shows, or ANALYSIS_NO_SCORE (hidden)
+    std::vector<bool> shownExact;
+    int k;
+};
+
+#endif
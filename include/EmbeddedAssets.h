@@ -0,0 +1,18 @@
+// EmbeddedAssets.h
+#ifndef EMBEDDEDASSETS_H
+#define EMBEDDEDASSETS_H
+
+#include <cstddef>
+
+// A file compiled into the executable.
+struct EmbeddedAsset {
+    const unsigned char* data;
+    std::size_t size;
+};
+
+// The fonts in assets/, generated into the build by cmake/EmbedAssets.cmake. Only builds
+// that define HEX_EMBEDDED_FONTS link them; other builds read the files at startup.
+extern const EmbeddedAsset EMBEDDED_FONT_STANDARD;  // assets/Arial.ttf
+extern const EmbeddedAsset EMBEDDED_FONT_CURSIVE;   // assets/Cursive.ttf
+
+#endif
@@ -0,0 +1,66 @@
+// FrameScheduler.h
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <SFML/Graphics.hpp>
+
+// How the main loop decides when to draw.
+enum FramePacing {
+    PACING_EVENT_DRIVEN,  // Sleep until input or a scheduled wake-up; draw only when needed
+    PACING_CAPPED         // Draw continuously, at most frameRateLimit times per second
+};
+
+// Decides when the game loop should wake up and when it should draw.
+//
+// In event-driven mode the loop blocks in waitEvent() until an event arrives or the earliest
+// requested redraw is due; redraws are requested for input (requestRedraw), for clock-driven
+// content such as the timer (requestRedrawIn) and, one frame at a time, for animations
+// (requestAnimationFrame, paced by the frame-rate limit). SFML 2's waitEvent() has no timeout,
+// so the wait polls for events in short sleeps until the deadline. Polls start POLL_INTERVAL
+// apart; after IDLE_POLLS_BEFORE_BACKOFF polls without input the interval doubles, up to
+// MAX_POLL_INTERVAL, and the next event resets it. Sleeps never run past the deadline.
+class FrameScheduler {
+public:
+    explicit FrameScheduler(FramePacing pacing = PACING_EVENT_DRIVEN, unsigned frameRateLimit = 60);
+
+    void setPacing(FramePacing newPacing);
+    FramePacing getPacing() const { return pacing; }
+
+    // Draw as soon as possible (something visible changed).
+    void requestRedraw() { redrawPending = true; }
+    // Draw no later than 'delay' from now.
+    void requestRedrawIn(sf::Time delay);
+    // Draw the next animation frame, one frame interval after the previous frame.
+    void requestAnimationFrame();
+
+    // Waits until an event arrives (returns true and fills 'event') or a frame is due
+    // (returns false).
+    bool waitEvent(sf::RenderWindow& window, sf::Event& event);
+    // True if a frame should be drawn now. Consumes the pending request.
+    bool frameDue();
+    // Time spent blocked in waitEvent() since the last call.
+    double takeIdleSeconds();
+
+private:
+    static const sf::Time POLL_INTERVAL;
+    static const sf::Time MAX_POLL_INTERVAL;
+    static const int IDLE_POLLS_BEFORE_BACKOFF = 4;
+
+    void scheduleAt(sf::Time time);
+    void sleepFor(sf::Time duration);
+    // Sleep before the next poll for events, backing off while none arrive.
+    sf::Time nextPollInterval();
+
+    FramePacing pacing;
+    sf::Time frameInterval;
+    sf::Clock clock;
+    sf::Time lastFrame;
+    sf::Time deadline;
+    bool hasDeadline;
+    bool redrawPending;
+    double idleSeconds;
+    sf::Time pollInterval;  // Current sleep between polls for events
+    int emptyPolls;         // Polls without an event since the last one
+};
+
+#endif
@@ -0,0 +1,59 @@
+// FrameStats.h
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Frame-time instrumentation. Every drawn frame records how long it spent handling events
+// and drawing; the total goes into a fixed-resolution histogram (10 µs buckets up to 100 ms,
+// plus an overflow bucket) from which percentiles are read. Time the loop spends blocked
+// waiting for work is recorded separately, so busyFraction() shows how much of a core the
+// game actually uses.
+class FrameStats {
+public:
+    static const int BUCKET_MICROS = 10;
+    static const int BUCKET_COUNT = 10000;
+
+    FrameStats();
+
+    // Adds the cost of one loop iteration. Iterations that did not draw only count
+    // towards the event-handling total.
+    void recordFrame(double eventSeconds, double drawSeconds, bool drew);
+    // Adds time spent sleeping or blocked waiting for events.
+    void recordIdle(double seconds) { idleSeconds += seconds; }
+    // Records how long after startup the first frame was shown.
+    void recordFirstFrame(double seconds) { firstFrame = seconds; }
+
+    std::uint64_t frames() const { return drawnFrames; }
+    std::uint64_t iterations() const { return loopIterations; }
+    // Frame time (events + draw) at percentile p in [0, 1], in seconds.
+    double percentile(double p) const;
+    double meanDrawSeconds() const { return drawnFrames ? drawSeconds / drawnFrames : 0.0; }
+    // Event handling per loop iteration, drawn or not.
+    double meanEventSeconds() const { return loopIterations ? eventSeconds / loopIterations : 0.0; }
+    // Share of wall-clock time not spent waiting.
+    double busyFraction() const;
+    double wallSeconds() const;
+    // Startup to first frame in seconds, or 0 before it is recorded.
+    double firstFrameSeconds() const { return firstFrame; }
+
+    // One-line summary for the on-screen overlay.
+    std::string summary() const;
+    // Multi-line report, printed when the game exits.
+    void dump(std::ostream& out) const;
+
+private:
+    std::vector<std::uint32_t> histogram;
+    std::uint64_t drawnFrames;
+    std::uint64_t loopIterations;
+    double eventSeconds;
+    double drawSeconds;
+    double idleSeconds;
+    double firstFrame;
+    double startTime;
+};
+
+#endif
@@ -2,19 +2,48 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "BoardRenderer.h"
+#include "FrameScheduler.h"
+#include "FrameStats.h"
+#include "GameRecord.h"
 #include "HexBoard.h"
+#include "MctsEngine.h"
+#include "NetProtocol.h"
+#include "PositionAnalyzer.h"
+#include "Tablebase.h"
+#include "Trace.h"
 #include "UI.h"
 #include <SFML/Graphics.hpp>
+#include <memory>
 #include <string>
+#include <vector>
+
+const float AI_MOVE_SECONDS = 1.0f;  // Thinking time per computer move
+const sf::Time FRAME_STATS_REFRESH = sf::milliseconds(500);  // Overlay refresh interval
+const sf::Time REMOTE_POLL_INTERVAL = sf::milliseconds(20);   // Server polling while waiting
+const sf::Time ANALYSIS_POLL_INTERVAL = sf::milliseconds(50); // Snapshot polling while analysing
+const sf::Time AI_STATS_REFRESH = sf::milliseconds(250);      // aiLabel refresh while thinking
+const char* const GAME_RECORD_PATH = "games.hxgr";           // Archive every game is appended to
 
 class Game {
 public:
     Game();
+    // Headless game (used by the benchmarks): no window is opened and the layout assumes a
+    // drawing surface of the given size. Frames are rendered with drawFrame().
+    explicit Game(const sf::Vector2u& surfaceSize);
     void run();
+    // Plays against a remote opponent through hex_server instead of on one screen. Returns
+    // false (and prints why) if the server cannot be reached.
+    bool connectRemote(const std::string& host, std::uint16_t port);
+    // Draws one complete frame of the current state to 'target'.
+    void drawFrame(sf::RenderTarget& target);
     
 private:
+    sf::Clock startupClock;   // Declared first: time to first frame counts from here.
     sf::RenderWindow window;
-    HexBoard board;
+    sf::Vector2u surfaceSize; // Size of the window (or offscreen surface) the layout is for.
+    GameBoard board;
+    BoardRenderer boardRenderer; // Cached board geometry, drawn in one call.
     char currentPlayer;
     bool gameOver;
     std::string winnerText;
@@ -24,11 +53,92 @@ private:
     sf::Color bgColor;        // Background color (toggled with 'B').
     sf::Clock animationClock; // Clock for winner animation.
     sf::Clock gameClock;      // Clock for elapsed game time.
+    MctsEngine<GameBoard> ai; // Background search for the computer opponent.
+    bool aiEnabled;           // Whether aiPlayer is controlled by the computer (toggled with 'A').
+    char aiPlayer;            // The side the computer plays.
+    bool aiThinking;          // A search has been started and its move not yet applied.
+    Tablebase tablebase;      // Solved positions (TABLEBASE_DEFAULT_PATH), if the file is there.
+    std::unique_ptr<PositionAnalyzer> analyzer;  // Started the first time analysis is turned on.
+    bool analysisEnabled;          // Heat map over the empty cells (toggled with 'E').
+    std::uint64_t analysisPosition; // The analyzer's number for the position on the board.
+    AnalysisSnapshot analysis;     // Newest snapshot taken from the analyzer.
+    AnalysisOverlay analysisOverlay;
+    
+    // Retained UI text. Labels whose text follows the game state are set when that state
+    // changes (the update*Label() functions below); drawFrame() only places and draws them.
+    // The timer and the frame-time overlay follow the clock and are refreshed in drawFrame().
+    TextLabel titleLabel;
+    TextLabel turnLabel;
+    TextLabel timerLabel;
+    TextLabel winnerLabel;
+    TextLabel promptLabel;
+    TextLabel aiLabel;
+    TextLabel analysisLabel;
+    TextLabel signatureLabel;
+    sf::RectangleShape timerPanel; // Semi-transparent panel behind the timer.
+    int timerSeconds;              // Seconds currently shown on timerLabel.
+    sf::Clock aiStatsClock;        // Time since aiLabel was last refreshed.
+    
+    FrameScheduler scheduler;      // Decides when to wake up and redraw (toggled with 'P').
+    FrameStats frameStats;         // Frame-time histogram, dumped on exit.
+    bool showFrameStats;           // Frame-time overlay visible (toggled with F3).
+    TextLabel frameStatsLabel;
+    sf::Clock frameStatsClock;     // Throttles refreshes of frameStatsLabel.
+    
+    NetClient remote;              // Connection to hex_server, if playing online.
+    bool remoteEnabled;            // Moves go through the server (set by connectRemote()).
+    bool remotePlaying;            // Paired with an opponent and the game not yet over.
+    bool remoteMovePending;        // Our move was sent; the server's echo plays it.
+    char localPlayer;              // Our side in the online game.
+    std::string remoteStatus;      // Shown in remoteLabel.
+    TextLabel remoteLabel;
+    
+    std::vector<int> moveHistory;  // Cells played in the current game, in order.
+    GameRecordWriter recorder;     // Appends finished (and abandoned) games to GAME_RECORD_PATH.
     
     // Recalculate board offset based on the current window size.
     void recalcBoardOffset();
     
+    void handleEvent(const sf::Event& event);
+    // Index of the board cell under the screen position (x, y), or -1.
+    int cellAtScreen(int x, int y) const;
     void handleClick(int x, int y);
+    // Whether the local player may place a mark now.
+    bool canPlayLocally() const;
+    // Highlights the empty cell under the pointer, if it can be played.
+    void updateHover(int x, int y);
+    // Places the current player's mark on the given cell and advances the turn.
+    void playMove(int index);
+    // Appends the current game (if any moves were made) to the archive and clears the history.
+    void recordGame();
+    // Maps the tablebase for the game board, if one has been generated.
+    void loadTablebase();
+    // Reports the time to first frame (and what font loading took of it) to the frame stats,
+    // the trace and the startup metric.
+    void recordFirstFrame();
+    // Plays the tablebase move, or starts a background search, if it is the computer's turn.
+    void startAiTurn();
+    // Applies the computer's move once its search has finished. Called once per frame.
+    void pollAi();
+    // Hands the position on the board to the analyzer, if analysis is on.
+    void updateAnalysis();
+    // Shows the analyzer's newest snapshot, if it has published one. Called once per frame.
+    void pollAnalysis();
+    // Handles messages from the server: game start, moves (ours and the opponent's), and
+    // the opponent leaving. Called once per frame.
+    void pollRemote();
+    // Sets turnLabel and promptLabel for the side to move, the game being over, and online play.
+    void updateTurnLabels();
+    // Sets winnerLabel from winnerText, in the winner's color.
+    void updateWinnerLabel();
+    // Sets remoteLabel from remoteStatus.
+    void updateRemoteLabel();
+    // Sets aiLabel from the search statistics and the tablebase entry for the position.
+    void updateAiLabel();
+    // Sets analysisLabel from the newest snapshot, or "starting" if it is for an older position.
+    void updateAnalysisLabel();
+    // Back to an empty board with X to move.
+    void resetBoard();
     void draw();
 };
 
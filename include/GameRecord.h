@@ -0,0 +1,128 @@
+// GameRecord.h
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include "HexGeometry.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Binary game archive. All integers are little-endian.
+//
+//   archive   "HXGR", version byte, 3 reserved bytes, then blocks
+//   block     u32 payload bytes, u32 record count, then that many records
+//   record    u8 radius, u8 win length, u8 result (GameResult), u16 move count, moves
+//
+// A move is its cell index (see HexBoard::cellIndex): one byte, or two on boards with more
+// than 256 cells. A game on the 19-cell board is 5 + n bytes. Blocks let a reader split an
+// archive between threads by hopping over block headers, without parsing every record.
+
+const std::uint8_t GAME_ARCHIVE_VERSION = 1;
+const std::size_t GAME_ARCHIVE_HEADER_BYTES = 8;
+const std::size_t GAME_BLOCK_HEADER_BYTES = 8;
+const std::size_t GAME_RECORD_HEADER_BYTES = 5;
+const std::size_t GAME_BLOCK_BYTES = 64 * 1024;  // Payload size at which the writer starts a new block
+
+enum GameResult : std::uint8_t {
+    RESULT_UNFINISHED = 0,
+    RESULT_X_WINS = 1,
+    RESULT_O_WINS = 2,
+    RESULT_DRAW = 3
+};
+const int GAME_RESULT_COUNT = 4;
+
+// Result of a game given the winner ('X', 'O' or ' ') and whether the board is full.
+inline GameResult gameResultFor(char winner, bool full) {
+    return winner == 'X' ? RESULT_X_WINS : (winner == 'O' ? RESULT_O_WINS : (full ? RESULT_DRAW : RESULT_UNFINISHED));
+}
+
+// Bytes per move on a board of the given radius.
+constexpr int gameMoveBytes(int radius) {
+    return hexCellCount(radius) > 256 ? 2 : 1;
+}
+
+// A record as it lies in the archive; 'moves' points into the archive's memory.
+struct GameRecordView {
+    int radius;
+    int winLength;
+    GameResult result;
+    int moveCount;
+    const std::uint8_t* moves;
+
+    int move(int i) const {
+        return gameMoveBytes(radius) == 1 ? moves[i] : (moves[2 * i] | (moves[2 * i + 1] << 8));
+    }
+};
+
+// Decodes the record at 'data' and advances it past the record. Returns false if the record
+// is malformed or runs past 'end'.
+bool readGameRecord(const std::uint8_t*& data, const std::uint8_t* end, GameRecordView& record);
+
+// Appends records to an archive through an in-memory block buffer; a block is written out
+// when it fills up, on flush(), and on destruction. The file is opened (and the archive
+// header written, if it is new) on the first append. A partial block or header at the end of
+// an existing archive, left by an interrupted writer, is truncated away before appending; a
+// file that is not an archive is left alone and the writer fails.
+class GameRecordWriter {
+public:
+    explicit GameRecordWriter(const std::string& path);
+    ~GameRecordWriter();
+
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    // Buffers one game. 'moves' are cell indices in the order they were played.
+    bool append(int radius, int winLength, GameResult result, const std::vector<int>& moves);
+    // Writes the buffered records as a block and flushes the file.
+    bool flush();
+    // False once opening or writing the file has failed.
+    bool good() const { return !failed; }
+
+private:
+    bool open();
+    bool writeBlock();
+
+    std::string path;
+    std::FILE* file;
+    std::vector<std::uint8_t> block;  // Payload of the block being filled
+    std::uint32_t blockRecords;
+    bool failed;
+};
+
+// A contiguous run of records inside an archive.
+struct GameBlock {
+    const std::uint8_t* data;
+    std::size_t bytes;
+    std::uint32_t records;
+};
+
+// Read-only, memory-mapped archive. open() maps the file and indexes its blocks; records are
+// decoded in place with readGameRecord(), so archives larger than memory are paged in as
+// they are read.
+class GameArchive {
+public:
+    GameArchive();
+    ~GameArchive();
+
+    GameArchive(const GameArchive&) = delete;
+    GameArchive& operator=(const GameArchive&) = delete;
+
+    // Returns false and sets 'error' if the file cannot be mapped or is not an archive. A
+    // truncated final block (from an interrupted writer) is dropped and flagged by truncated().
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    const std::vector<GameBlock>& blocks() const { return blockList; }
+    std::size_t bytes() const { return size; }
+    bool truncated() const { return truncatedTail; }
+
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::vector<GameBlock> blockList;
+    bool truncatedTail;
+};
+
+#endif
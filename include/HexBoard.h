@@ -2,16 +2,17 @@
 #ifndef HEXBOARD_H
 #define HEXBOARD_H
 
+#include "HexGeometry.h"
+#include <bitset>
+#include <cstdint>
+#include <memory>
 #include <vector>
-#include <SFML/Graphics.hpp>
 
-const int BOARD_RADIUS = 2;      // A board with side length 3 (radius 2) gives 19 cells
-const float HEX_SIZE = 50.0f;      // Hexagon “radius” (distance from center to vertex)
-const float HEX_SPACING = 0.0f;    // No extra spacing (cells share walls)
+// The rules only: this header (and everything in the hexttt_core library) has no SFML
+// dependency. Screen layout of the board lives in HexGraphics.h.
 
-extern sf::Color AMU_RED;
-extern sf::Color AMU_GREEN;
-extern sf::Color AMU_WHITE;
+const int BOARD_RADIUS = 2;      // A board with side length 3 (radius 2) gives 19 cells
+const int WIN_LENGTH = 3;        // Marks in a row needed to win
 
 // Structure representing a single hex cell in axial coordinates.
 struct HexCell {
@@ -20,24 +21,167 @@ struct HexCell {
     char value;  // ' ' (empty), 'X', or 'O'
 };
 
+// Lightweight, read-only view of a board's cells. Iterating it yields HexCell values
+// reconstructed from the bitboards, so no per-cell storage has to be kept in sync.
+template <class Board>
+class HexCellView {
+public:
+    class iterator {
+    public:
+        iterator(const Board* board, int index) : board(board), index(index) {}
+        HexCell operator*() const { return board->cellAt(index); }
+        iterator& operator++() { ++index; return *this; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+    private:
+        const Board* board;
+        int index;
+    };
+
+    explicit HexCellView(const Board* board) : board(board) {}
+    iterator begin() const { return iterator(board, 0); }
+    iterator end() const { return iterator(board, board->cellCount()); }
+    int size() const { return board->cellCount(); }
+    HexCell operator[](int index) const { return board->cellAt(index); }
+private:
+    const Board* board;
+};
+
+// Board whose size is fixed at compile time: Radius rings around the centre, K marks in a
+// row to win. All lookup tables are constexpr, each player's marks are a std::bitset, and a
+// move plus its win check touch O(K) cells regardless of the board size.
+template <int Radius, int K>
 class HexBoard {
 public:
-    HexBoard();
+    typedef HexTables<Radius, K> Tables;
+    typedef HexCellView<HexBoard> CellView;
+
+    static constexpr int RADIUS = Radius;
+    static constexpr int LINE_LENGTH = K;
+    static constexpr int CELL_COUNT = Tables::CELLS;
+    static constexpr Tables TABLES = makeHexTables<Radius, K>();
+
+    HexBoard() : occupied(0) {}
+
+    // Maps axial coordinates to a cell index, or -1 if (q, r) lies off the board.
+    static int cellIndex(int q, int r) { return TABLES.cellIndex(q, r); }
+    static int cellCount() { return CELL_COUNT; }
+    int radius() const { return Radius; }
+    int winLength() const { return K; }
+
     // Attempt to place a move at axial coordinates (q, r)
-    bool makeMove(int q, int r, char player);
-    // Check for a winner (three consecutive cells in any direction)
-    char checkWinner();
-    // Draw all hex cells to the window using the provided offset (to center the board)
-    void draw(sf::RenderWindow& window, const sf::Vector2f& offset);
+    bool makeMove(int q, int r, char player) { return makeMoveAt(cellIndex(q, r), player); }
+    // Attempt to place a move on the given cell index.
+    bool makeMoveAt(int index, char player) {
+        if (index < 0 || xStones[index] || oStones[index])
+            return false;
+        if (player == 'X')
+            xStones.set(index);
+        else
+            oStones.set(index);
+        occupied++;
+        return true;
+    }
+    // Check for a winner (K consecutive cells in any direction)
+    char checkWinner() const {
+        if (hexrules::hasLine(TABLES, xStones, K))
+            return 'X';
+        if (hexrules::hasLine(TABLES, oStones, K))
+            return 'O';
+        return ' ';
+    }
+    // Check only the lines through (q, r). Equivalent to checkWinner() when (q, r) is the
+    // most recent move and the position had no winner before it.
+    char checkWinnerAfter(int q, int r) const { return checkWinnerAt(cellIndex(q, r)); }
+    char checkWinnerAt(int index) const {
+        if (index < 0)
+            return ' ';
+        if (xStones[index])
+            return hexrules::completesLine(TABLES, xStones, index, K) ? 'X' : ' ';
+        if (oStones[index])
+            return hexrules::completesLine(TABLES, oStones, index, K) ? 'O' : ' ';
+        return ' ';
+    }
     // Returns true if every cell is occupied.
-    bool isFull();
-    // Returns a reference to the vector of cells (for mouse click detection).
-    std::vector<HexCell>& getCells();
-    // Convert axial coordinates (q, r) to pixel coordinates (for flat-topped hexes)
-    sf::Vector2f axialToPixel(int q, int r);
-    
+    bool isFull() const { return occupied == CELL_COUNT; }
+    // Number of marks placed so far.
+    int moveCount() const { return occupied; }
+    // ' ', 'X' or 'O' for the given cell index.
+    char valueAt(int index) const { return xStones[index] ? 'X' : (oStones[index] ? 'O' : ' '); }
+    // Returns a view over the cells.
+    CellView getCells() const { return CellView(this); }
+    // Returns the cell stored at the given index (see cellIndex()).
+    HexCell cellAt(int index) const {
+        HexCell cell;
+        cell.q = TABLES.coords[index][0];
+        cell.r = TABLES.coords[index][1];
+        cell.value = valueAt(index);
+        return cell;
+    }
+
+private:
+    std::bitset<CELL_COUNT> xStones;  // Cells occupied by 'X'
+    std::bitset<CELL_COUNT> oStones;  // Cells occupied by 'O'
+    int occupied;                     // Number of set bits across both bitboards
+};
+
+// Growable bit set for DynamicHexBoard; indexing mirrors std::bitset.
+class DynamicBits {
+public:
+    explicit DynamicBits(int bits = 0) : words((bits + 63) / 64, 0) {}
+    bool operator[](int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+    void set(int index) { words[index >> 6] |= std::uint64_t(1) << (index & 63); }
 private:
-    std::vector<HexCell> cells;
+    std::vector<std::uint64_t> words;
 };
 
+// Board whose radius and win length are chosen at runtime. Same interface and rules as
+// HexBoard<Radius, K>, backed by a shared HexGeometry instead of constexpr tables.
+class DynamicHexBoard {
+public:
+    typedef HexCellView<DynamicHexBoard> CellView;
+
+    DynamicHexBoard(int radius, int k);
+
+    int cellIndex(int q, int r) const { return geometry->cellIndex(q, r); }
+    int cellCount() const { return geometry->cellCount(); }
+    int radius() const { return geometry->radius(); }
+    int winLength() const { return geometry->winLength(); }
+
+    bool makeMove(int q, int r, char player) { return makeMoveAt(cellIndex(q, r), player); }
+    bool makeMoveAt(int index, char player);
+    char checkWinner() const;
+    char checkWinnerAfter(int q, int r) const { return checkWinnerAt(cellIndex(q, r)); }
+    char checkWinnerAt(int index) const;
+    bool isFull() const { return occupied == cellCount(); }
+    int moveCount() const { return occupied; }
+    char valueAt(int index) const { return xStones[index] ? 'X' : (oStones[index] ? 'O' : ' '); }
+    CellView getCells() const { return CellView(this); }
+    HexCell cellAt(int index) const;
+
+private:
+    std::shared_ptr<const HexGeometry> geometry;
+    DynamicBits xStones;
+    DynamicBits oStones;
+    int occupied;
+};
+
+// The board the windowed game is played on.
+typedef HexBoard<BOARD_RADIUS, WIN_LENGTH> GameBoard;
+
+// Calls fn with an empty board of the requested size. Common sizes get their compile-time
+// specialisation; anything else falls back to DynamicHexBoard. fn must be callable with
+// every board type (typically a generic lambda) and return the same type for each.
+template <class Fn>
+auto withHexBoard(int radius, int k, Fn&& fn) {
+    if (radius == 2 && k == 3)
+        return fn(HexBoard<2, 3>());
+    if (radius == 10 && k == 5)
+        return fn(HexBoard<10, 5>());
+    if (radius == 25 && k == 5)
+        return fn(HexBoard<25, 5>());
+    if (radius == 50 && k == 5)
+        return fn(HexBoard<50, 5>());
+    return fn(DynamicHexBoard(radius, k));
+}
+
 #endif
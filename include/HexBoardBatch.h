@@ -0,0 +1,100 @@
+// HexBoardBatch.h
+#ifndef HEXBOARDBATCH_H
+#define HEXBOARDBATCH_H
+
+#include "HexGeometry.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 256 bits: one bit per board of a group, for one cell (or one result).
+struct alignas(32) HexBatchLanes {
+    std::uint64_t words[4];
+};
+
+// Implementation used by HexBoardBatch::evaluate().
+enum HexBatchKernel {
+    BATCH_KERNEL_AUTO,    // AVX2 if the CPU has it, else scalar
+    BATCH_KERNEL_SCALAR,  // 64-bit words; runs anywhere
+    BATCH_KERNEL_AVX2     // 256-bit vectors; falls back to scalar without AVX2
+};
+
+// Per-board results of HexBoardBatch::evaluate(), as bit masks (bit i = board i).
+struct HexBatchResults {
+    std::vector<std::uint64_t> xWins;
+    std::vector<std::uint64_t> oWins;
+    std::vector<std::uint64_t> full;
+
+    // Same answers as Board::checkWinner() and Board::isFull() for board i.
+    char winner(std::size_t i) const {
+        if (bit(xWins, i))
+            return 'X';
+        return bit(oWins, i) ? 'O' : ' ';
+    }
+    bool isFull(std::size_t i) const { return bit(full, i); }
+
+private:
+    static bool bit(const std::vector<std::uint64_t>& mask, std::size_t i) { return (mask[i >> 6] >> (i & 63)) & 1; }
+};
+
+// Many independent positions of one board size, stored bit-sliced (structure of arrays):
+// for every group of 256 boards and every cell there is one 256-bit plane per player, whose
+// bit b says whether board b of the group has a mark there. A k-in-a-row then becomes the
+// AND of k planes, so one vector instruction checks a line on 256 boards at once, and
+// "full" is the AND of (X | O) over every cell. This answers checkWinner() and isFull() for
+// millions of positions far faster than asking each board in turn; building the batch
+// (add(), setCell()) is the comparatively slow part and is meant to be done once per batch.
+class HexBoardBatch {
+public:
+    static const std::size_t GROUP_BOARDS = 256;
+
+    HexBoardBatch(int radius, int k);
+
+    int radius() const { return geometry->radius(); }
+    int winLength() const { return geometry->winLength(); }
+    int cellCount() const { return cells; }
+    std::size_t size() const { return boards; }
+
+    // Removes every board; the memory is kept for reuse.
+    void clear();
+    // Appends an empty board and returns its index.
+    std::size_t addEmpty();
+    // Appends a copy of 'board' (any HexBoard-like board of this size) and returns its index.
+    template <class Board>
+    std::size_t add(const Board& board) {
+        std::size_t index = addEmpty();
+        for (int cell = 0; cell < cells; cell++) {
+            char value = board.valueAt(cell);
+            if (value != ' ')
+                setCell(index, cell, value);
+        }
+        return index;
+    }
+    // Places 'player' ('X' or 'O') on 'cell' of board 'index'. Does not check that the cell is empty.
+    void setCell(std::size_t index, int cell, char player) {
+        std::size_t group = index / GROUP_BOARDS;
+        std::size_t lane = index % GROUP_BOARDS;
+        std::vector<HexBatchLanes>& planes = player == 'X' ? xPlanes : oPlanes;
+        planes[group * cells + cell].words[lane >> 6] |= std::uint64_t(1) << (lane & 63);
+    }
+
+    // Winner and fullness of every board.
+    void evaluate(HexBatchResults& results, HexBatchKernel kernel = BATCH_KERNEL_AUTO) const;
+
+    // True if this build and CPU can run BATCH_KERNEL_AVX2.
+    static bool avx2Available();
+    // The kernel BATCH_KERNEL_AUTO resolves to.
+    static HexBatchKernel defaultKernel();
+    static const char* kernelName(HexBatchKernel kernel);
+
+private:
+    std::shared_ptr<const HexGeometry> geometry;
+    int cells;
+    std::vector<std::int16_t> lineCells;   // k cells per line, lines in geometry order
+    std::size_t boards;
+    std::vector<HexBatchLanes> xPlanes;    // [group * cells + cell]
+    std::vector<HexBatchLanes> oPlanes;
+};
+
+#endif
@@ -0,0 +1,209 @@
+// HexGeometry.h
+#ifndef HEXGEOMETRY_H
+#define HEXGEOMETRY_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Axial neighbor directions for flat-topped hexagons. Direction d and d + 3 are opposite,
+// so the first three double as the axes a line can run along.
+constexpr int HEX_DIRECTIONS[6][2] = {
+    {1, 0}, {0, 1}, {-1, 1},
+    {-1, 0}, {0, -1}, {1, -1}
+};
+
+// Cell indices are stored as 16-bit values, which caps the supported radius.
+const int MAX_BOARD_RADIUS = 100;
+
+// Number of cells on a hexagonal board of the given radius.
+constexpr int hexCellCount(int radius) {
+    return 3 * radius * (radius + 1) + 1;
+}
+
+// Number of distinct k-in-a-row segments on a board of the given radius. Along each axis the
+// rows have lengths R + 1 ... 2R + 1 ... R + 1, and a row of length L holds L - k + 1 segments.
+constexpr int hexLineCount(int radius, int k) {
+    int perAxis = 0;
+    for (int row = -radius; row <= radius; row++) {
+        int length = 2 * radius + 1 - (row < 0 ? -row : row);
+        if (length >= k)
+            perAxis += length - k + 1;
+    }
+    return 3 * perAxis;
+}
+
+// A k-in-a-row segment: the first cell and the axis (0..2) it runs along. Three bytes rather
+// than a mask of the whole board: a radius-50 board has 21,741 lines of 5, and 7,651-bit masks
+// would take 21 MB, with every test ANDing 120 words instead of following k neighbors.
+struct HexLine {
+    std::int16_t start;
+    std::int8_t axis;
+};
+
+// Fills the lookup tables shared by every board representation. 'tables' must expose
+// index / coords / neighbors / lines containers already sized for (radius, k):
+//   index[(q + R) * span + (r + R)] -> cell index, or -1 outside the hexagon
+//   coords[cell]                    -> {q, r}
+//   neighbors[cell][d]              -> cell index one step along HEX_DIRECTIONS[d], or -1
+//   lines[i]                        -> every k-in-a-row, in cell-index order
+// Cells are numbered q major, r minor, which is the order the board has always enumerated them.
+template <class Tables>
+constexpr void fillHexTables(Tables& tables, int radius, int k) {
+    int span = 2 * radius + 1;
+    int next = 0;
+    for (int q = -radius; q <= radius; q++) {
+        for (int r = -radius; r <= radius; r++) {
+            int s = -q - r;
+            int slot = (q + radius) * span + (r + radius);
+            if (s >= -radius && s <= radius) {
+                tables.index[slot] = static_cast<std::int16_t>(next);
+                tables.coords[next][0] = static_cast<std::int16_t>(q);
+                tables.coords[next][1] = static_cast<std::int16_t>(r);
+                next++;
+            } else {
+                tables.index[slot] = -1;
+            }
+        }
+    }
+    int lineCount = 0;
+    for (int cell = 0; cell < next; cell++) {
+        int q = tables.coords[cell][0];
+        int r = tables.coords[cell][1];
+        for (int d = 0; d < 6; d++) {
+            int nq = q + HEX_DIRECTIONS[d][0];
+            int nr = r + HEX_DIRECTIONS[d][1];
+            bool inside = nq >= -radius && nq <= radius && nr >= -radius && nr <= radius;
+            tables.neighbors[cell][d] = inside
+                ? tables.index[(nq + radius) * span + (nr + radius)]
+                : static_cast<std::int16_t>(-1);
+        }
+    }
+    for (int cell = 0; cell < next; cell++) {
+        for (int axis = 0; axis < 3; axis++) {
+            // A segment fits if k - 1 further steps along the axis stay on the board.
+            int end = cell;
+            for (int step = 1; step < k && end >= 0; step++)
+                end = tables.neighbors[end][axis];
+            if (end >= 0) {
+                tables.lines[lineCount].start = static_cast<std::int16_t>(cell);
+                tables.lines[lineCount].axis = static_cast<std::int8_t>(axis);
+                lineCount++;
+            }
+        }
+    }
+}
+
+// Lookup tables for a board size known at compile time. Instances are built entirely
+// in constant evaluation (see HexBoard<Radius, K>::TABLES).
+template <int Radius, int K>
+struct HexTables {
+    static_assert(Radius >= 0 && Radius <= MAX_BOARD_RADIUS, "unsupported board radius");
+    static_assert(K >= 1, "win length must be positive");
+
+    static constexpr int SPAN = 2 * Radius + 1;
+    static constexpr int CELLS = hexCellCount(Radius);
+    static constexpr int LINES = hexLineCount(Radius, K);
+
+    std::array<std::int16_t, SPAN * SPAN> index{};
+    std::array<std::array<std::int16_t, 2>, CELLS> coords{};
+    std::array<std::array<std::int16_t, 6>, CELLS> neighbors{};
+    std::array<HexLine, LINES> lines{};
+
+    constexpr int radius() const { return Radius; }
+    constexpr int winLength() const { return K; }
+    constexpr int cellCount() const { return CELLS; }
+    constexpr int cellIndex(int q, int r) const {
+        return (q < -Radius || q > Radius || r < -Radius || r > Radius)
+            ? -1
+            : index[(q + Radius) * SPAN + (r + Radius)];
+    }
+};
+
+template <int Radius, int K>
+constexpr HexTables<Radius, K> makeHexTables() {
+    HexTables<Radius, K> tables{};
+    fillHexTables(tables, Radius, K);
+    return tables;
+}
+
+// The same tables for a board size chosen at runtime. Instances are immutable and shared:
+// use HexGeometry::get() rather than building one per board.
+class HexGeometry {
+public:
+    static std::shared_ptr<const HexGeometry> get(int radius, int k);
+
+    HexGeometry(int radius, int k);
+
+    int radius() const { return boardRadius; }
+    int winLength() const { return lineLength; }
+    int cellCount() const { return static_cast<int>(coords.size()); }
+    int cellIndex(int q, int r) const {
+        return (q < -boardRadius || q > boardRadius || r < -boardRadius || r > boardRadius)
+            ? -1
+            : index[(q + boardRadius) * span + (r + boardRadius)];
+    }
+
+    std::vector<std::int16_t> index;
+    std::vector<std::array<std::int16_t, 2>> coords;
+    std::vector<std::array<std::int16_t, 6>> neighbors;
+    std::vector<HexLine> lines;
+
+private:
+    int boardRadius;
+    int lineLength;
+    int span;
+};
+
+// Centre of cell (q, r) for flat-topped hexagons of the given size (centre-to-corner
+// distance), and the exact inverse: the cell whose hexagon contains (x, y). HexGraphics.h
+// wraps these in SFML types for the game.
+void hexAxialToPoint(int q, int r, float size, float& x, float& y);
+void hexPointToAxial(float x, float y, float size, int& q, int& r);
+
+// Win detection shared by the compile-time and runtime boards. 'stones' is any container
+// whose operator[] reports whether a cell holds the player's mark.
+namespace hexrules {
+
+// Number of consecutive marked cells starting one step from 'cell' in direction d (at most 'limit').
+template <class Tables, class Stones>
+inline int runLength(const Tables& tables, const Stones& stones, int cell, int d, int limit) {
+    int run = 0;
+    for (int c = tables.neighbors[cell][d]; c >= 0 && run < limit && stones[c]; c = tables.neighbors[c][d])
+        run++;
+    return run;
+}
+
+// True if the mark on 'cell' is part of a k-in-a-row. Walks at most 2(k - 1) cells per axis.
+template <class Tables, class Stones>
+inline bool completesLine(const Tables& tables, const Stones& stones, int cell, int k) {
+    for (int axis = 0; axis < 3; axis++) {
+        int run = 1 + runLength(tables, stones, cell, axis, k - 1);
+        if (run < k)
+            run += runLength(tables, stones, cell, axis + 3, k - run);
+        if (run >= k)
+            return true;
+    }
+    return false;
+}
+
+// True if any precomputed line is fully marked.
+template <class Tables, class Stones>
+inline bool hasLine(const Tables& tables, const Stones& stones, int k) {
+    for (const auto &line : tables.lines) {
+        int cell = line.start;
+        int run = 0;
+        while (run < k && stones[cell]) {
+            run++;
+            cell = tables.neighbors[cell][line.axis];
+        }
+        if (run == k)
+            return true;
+    }
+    return false;
+}
+
+} // namespace hexrules
+
+#endif
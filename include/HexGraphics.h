@@ -0,0 +1,30 @@
+// HexGraphics.h
+#ifndef HEXGRAPHICS_H
+#define HEXGRAPHICS_H
+
+#include <SFML/Graphics.hpp>
+
+// How the board is laid out and colored on screen. Kept apart from HexBoard.h so the rules
+// build without SFML.
+
+const float HEX_SIZE = 50.0f;      // Hexagon “radius” (distance from center to vertex)
+const float HEX_SPACING = 0.0f;    // No extra spacing (cells share walls)
+
+extern sf::Color AMU_RED;
+extern sf::Color AMU_GREEN;
+extern sf::Color AMU_WHITE;
+
+// Convert axial coordinates (q, r) to pixel coordinates (for flat-topped hexes)
+sf::Vector2f hexAxialToPixel(int q, int r);
+// Exact inverse of hexAxialToPixel: the axial coordinates of the hexagon containing 'pixel'.
+void hexPixelToAxial(const sf::Vector2f& pixel, int& q, int& r);
+
+// Index of the cell of 'board' whose hexagon contains 'pixel' (board coordinates), or -1.
+template <class Board>
+int hexPixelToCell(const Board& board, const sf::Vector2f& pixel) {
+    int q, r;
+    hexPixelToAxial(pixel, q, r);
+    return board.cellIndex(q, r);
+}
+
+#endif
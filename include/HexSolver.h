@@ -0,0 +1,219 @@
+// HexSolver.h
+#ifndef HEXSOLVER_H
+#define HEXSOLVER_H
+
+#include "HexSymmetry.h"
+#include "Trace.h"
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Scores are from the side to move's point of view: WIN_SCORE - n means "wins with the
+// n-th ply from the root", -(WIN_SCORE - n) means "loses on ply n", 0 is a draw.
+const int SOLVER_WIN_SCORE = 10000;
+const int SOLVER_WIN_THRESHOLD = SOLVER_WIN_SCORE - 1000;
+
+struct SolveResult {
+    int score;             // Game-theoretic value for the side to move (see SOLVER_WIN_SCORE)
+    int bestMove;          // Cell index of an optimal move, or -1 if the game is already over
+    int pliesToEnd;        // Plies until the game ends under perfect play
+    char winner;           // 'X', 'O', or ' ' for a draw
+    std::uint64_t nodes;   // Positions visited
+    double seconds;        // Wall-clock time spent searching
+
+    double nodesPerSecond() const { return seconds > 0 ? nodes / seconds : 0.0; }
+};
+
+// 64-bit mixer used to derive deterministic Zobrist keys.
+inline std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Perfect-play solver: negamax with alpha-beta pruning over any HexBoard-like board.
+// Positions are hashed once per board symmetry, and the smallest of the 12 Zobrist hashes
+// is the transposition-table key, so all equivalent positions share one entry. Stored moves
+// are kept in that canonical frame and mapped back on lookup.
+template <class Board>
+class HexSolver {
+public:
+    explicit HexSolver(const Board& prototype, std::size_t tableMegabytes = 64)
+        : symmetries(prototype),
+          table(tableMegabytes),
+          cellCount(prototype.cellCount()),
+          keys(2 * prototype.cellCount()),
+          nodes(0) {
+        std::uint64_t seed = 0x6865787474740001ULL;
+        for (auto &key : keys)
+            key = splitMix64(seed);
+        sideKey = splitMix64(seed);
+        // Search cells closest to the centre first; they take part in the most lines.
+        for (int cell = 0; cell < cellCount; cell++)
+            moveOrder.push_back(cell);
+        std::stable_sort(moveOrder.begin(), moveOrder.end(), [&](int a, int b) {
+            return centreDistance(prototype, a) < centreDistance(prototype, b);
+        });
+    }
+
+    // Solves the position with the side to move inferred from the move count ('X' moves first).
+    SolveResult solve(const Board& board) {
+        return solve(board, board.moveCount() % 2 == 0 ? 'X' : 'O');
+    }
+
+    SolveResult solve(const Board& board, char toMove) {
+        auto start = std::chrono::steady_clock::now();
+        nodes = 0;
+        table.newSearch();
+
+        SolveResult result;
+        result.bestMove = -1;
+        char winner = board.checkWinner();
+        if (winner != ' ' || board.isFull()) {
+            result.score = winner == ' ' ? 0 : (winner == toMove ? SOLVER_WIN_SCORE : -SOLVER_WIN_SCORE);
+        } else {
+            Hashes hashes;
+            hashes.fill(toMove == 'O' ? sideKey : 0);
+            for (int cell = 0; cell < cellCount; cell++) {
+                char value = board.valueAt(cell);
+                if (value != ' ')
+                    toggle(hashes, cell, value);
+            }
+            Board work = board;
+            result.score = negamax(work, toMove, hashes, -SOLVER_WIN_SCORE, SOLVER_WIN_SCORE, 0, &result.bestMove);
+        }
+
+        if (result.score > SOLVER_WIN_THRESHOLD) {
+            result.winner = toMove;
+            result.pliesToEnd = SOLVER_WIN_SCORE - result.score;
+        } else if (result.score < -SOLVER_WIN_THRESHOLD) {
+            result.winner = toMove == 'X' ? 'O' : 'X';
+            result.pliesToEnd = SOLVER_WIN_SCORE + result.score;
+        } else {
+            result.winner = ' ';
+            result.pliesToEnd = cellCount - board.moveCount();
+        }
+        result.nodes = nodes;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        HEX_METRIC_ADD(metrics::solverNodes, static_cast<std::int64_t>(nodes));
+        HEX_TRACE_INFO(TRACE_SOLVE, static_cast<std::int32_t>(std::min<std::uint64_t>(nodes, INT32_MAX)),
+                       static_cast<std::int32_t>(result.seconds * 1000), result.score, result.bestMove);
+        return result;
+    }
+
+    const TranspositionTable& transpositionTable() const { return table; }
+
+private:
+    typedef std::array<std::uint64_t, HEX_SYMMETRY_COUNT> Hashes;
+
+    template <class B>
+    static int centreDistance(const B& board, int cell) {
+        auto c = board.cellAt(cell);
+        int s = -c.q - c.r;
+        return std::max(std::abs(c.q), std::max(std::abs(c.r), std::abs(s)));
+    }
+
+    // Updates the hash of every symmetric image of the position for a mark on 'cell'.
+    void toggle(Hashes& hashes, int cell, char player) const {
+        const std::uint64_t* playerKeys = &keys[player == 'X' ? 0 : cellCount];
+        for (int s = 0; s < HEX_SYMMETRY_COUNT; s++)
+            hashes[s] ^= playerKeys[symmetries.map(s, cell)];
+    }
+
+    static int canonicalSymmetry(const Hashes& hashes) {
+        return static_cast<int>(std::min_element(hashes.begin(), hashes.end()) - hashes.begin());
+    }
+
+    // Win/loss scores are stored relative to the node so they stay valid at any ply.
+    static int toTable(int score, int ply) {
+        return score > SOLVER_WIN_THRESHOLD ? score + ply : (score < -SOLVER_WIN_THRESHOLD ? score - ply : score);
+    }
+    static int fromTable(int score, int ply) {
+        return score > SOLVER_WIN_THRESHOLD ? score - ply : (score < -SOLVER_WIN_THRESHOLD ? score + ply : score);
+    }
+
+    int negamax(Board& board, char player, const Hashes& hashes, int alpha, int beta, int ply, int* bestMoveOut) {
+        nodes++;
+        char opponent = player == 'X' ? 'O' : 'X';
+
+        // A move that completes a line is always optimal: nothing ends the game sooner.
+        for (int cell : moveOrder) {
+            if (board.valueAt(cell) != ' ')
+                continue;
+            Board next = board;
+            next.makeMoveAt(cell, player);
+            if (next.checkWinnerAt(cell) == player) {
+                if (bestMoveOut)
+                    *bestMoveOut = cell;
+                return SOLVER_WIN_SCORE - (ply + 1);
+            }
+        }
+
+        int symmetry = canonicalSymmetry(hashes);
+        std::uint64_t key = hashes[symmetry];
+        int depth = cellCount - board.moveCount();
+        int ttMove = -1;
+        if (const TTEntry* entry = table.probe(key)) {
+            ttMove = entry->move >= 0 ? symmetries.unmap(symmetry, entry->move) : -1;
+            int score = fromTable(entry->score, ply);
+            if (!bestMoveOut) {
+                if (entry->bound == TT_EXACT)
+                    return score;
+                if (entry->bound == TT_LOWER && score >= beta)
+                    return score;
+                if (entry->bound == TT_UPPER && score <= alpha)
+                    return score;
+            }
+        }
+
+        int originalAlpha = alpha;
+        int bestScore = -SOLVER_WIN_SCORE - 1;
+        int bestMove = -1;
+        for (int i = -1; i < cellCount; i++) {
+            int cell = i < 0 ? ttMove : moveOrder[i];
+            if (cell < 0 || (i >= 0 && cell == ttMove) || board.valueAt(cell) != ' ')
+                continue;
+            Board next = board;
+            next.makeMoveAt(cell, player);
+            int score;
+            if (next.isFull()) {
+                score = 0;
+            } else {
+                Hashes nextHashes = hashes;
+                for (auto &h : nextHashes)
+                    h ^= sideKey;
+                toggle(nextHashes, cell, player);
+                score = -negamax(next, opponent, nextHashes, -beta, -alpha, ply + 1, nullptr);
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = cell;
+            }
+            if (score > alpha)
+                alpha = score;
+            if (alpha >= beta)
+                break;
+        }
+
+        TTBound bound = bestScore <= originalAlpha ? TT_UPPER : (bestScore >= beta ? TT_LOWER : TT_EXACT);
+        table.store(key, toTable(bestScore, ply), symmetries.map(symmetry, bestMove), bound, depth);
+        if (bestMoveOut)
+            *bestMoveOut = bestMove;
+        return bestScore;
+    }
+
+    HexSymmetries symmetries;
+    TranspositionTable table;
+    int cellCount;
+    std::vector<std::uint64_t> keys;  // keys[cell] for 'X', keys[cellCount + cell] for 'O'
+    std::uint64_t sideKey;            // Toggled into every hash when 'O' is to move
+    std::vector<int> moveOrder;
+    std::uint64_t nodes;
+};
+
+#endif
@@ -0,0 +1,54 @@
+// HexSymmetry.h
+#ifndef HEXSYMMETRY_H
+#define HEXSYMMETRY_H
+
+#include <cstdint>
+#include <vector>
+
+const int HEX_SYMMETRY_COUNT = 12;  // 6 rotations, each with and without a reflection
+
+// The symmetries of a hexagonal board as permutations of cell indices. In cube coordinates
+// (x, y, z) = (q, -q - r, r), a 60° rotation maps (x, y, z) -> (-z, -x, -y), i.e.
+// (q, r) -> (-r, q + r), and swapping x and z reflects the board: (q, r) -> (r, q).
+// Symmetry s applies s % 6 rotations, preceded by a reflection when s >= 6. Symmetry 0 is
+// the identity.
+class HexSymmetries {
+public:
+    template <class Board>
+    explicit HexSymmetries(const Board& board)
+        : cells(board.cellCount()),
+          forward(HEX_SYMMETRY_COUNT * board.cellCount()),
+          backward(HEX_SYMMETRY_COUNT * board.cellCount()) {
+        for (int s = 0; s < HEX_SYMMETRY_COUNT; s++) {
+            for (int cell = 0; cell < cells; cell++) {
+                auto c = board.cellAt(cell);
+                int q = c.q, r = c.r;
+                if (s >= 6) {
+                    int t = q;
+                    q = r;
+                    r = t;
+                }
+                for (int turn = 0; turn < s % 6; turn++) {
+                    int t = q;
+                    q = -r;
+                    r = t + r;
+                }
+                int image = board.cellIndex(q, r);
+                forward[s * cells + cell] = static_cast<std::int16_t>(image);
+                backward[s * cells + image] = static_cast<std::int16_t>(cell);
+            }
+        }
+    }
+
+    // Image of 'cell' under symmetry s.
+    int map(int s, int cell) const { return forward[s * cells + cell]; }
+    // Cell whose image under symmetry s is 'cell'.
+    int unmap(int s, int cell) const { return backward[s * cells + cell]; }
+
+private:
+    int cells;
+    std::vector<std::int16_t> forward;
+    std::vector<std::int16_t> backward;
+};
+
+#endif
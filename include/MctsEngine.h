@@ -0,0 +1,351 @@
+// MctsEngine.h
+#ifndef MCTSENGINE_H
+#define MCTSENGINE_H
+
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Search statistics, readable while a search is running.
+struct MctsStats {
+    std::uint64_t playouts;   // Simulations completed
+    std::size_t treeNodes;    // Nodes allocated from the arena
+    std::size_t arenaBytes;   // Memory reserved for the arena (allocated once, reused every move)
+    double seconds;           // Time spent on the current / last search
+    double value;             // Last search: mean result of the chosen move for the side that played it
+                              // (win 1, draw 1/2, loss 0)
+
+    double playoutsPerSecond() const { return seconds > 0 ? playouts / seconds : 0.0; }
+};
+
+// A tree node shared by every search thread. 'visits' is bumped on the way down, before the
+// playout result is known: that is the virtual loss which steers concurrent threads towards
+// other branches until the result is backed up. 'score' counts half-points (win = 2, draw = 1)
+// for the player who made 'move'.
+struct MctsNode {
+    static const std::int32_t UNEXPANDED = -1;
+    static const std::int32_t EXPANDING = -2;
+
+    std::atomic<std::uint32_t> visits;
+    std::atomic<std::uint32_t> score;
+    std::atomic<std::int32_t> firstChild;  // Arena index of the first child, or UNEXPANDED / EXPANDING
+    std::int32_t childCount;
+    std::int16_t move;                     // Cell index played to reach this node
+    std::uint8_t terminal;                 // 0, or the game result after 'move': 2 = mover won, 1 = draw
+};
+
+// Fixed-capacity node pool. Memory is allocated once; reset() makes it reusable for the next
+// move, and allocation is a single atomic bump so threads can expand nodes concurrently.
+class MctsArena {
+public:
+    explicit MctsArena(std::size_t capacity) : nodes(new MctsNode[capacity]), capacity(capacity), used(0) {}
+
+    // Reserves 'count' consecutive nodes and returns the first index, or -1 if the arena is full.
+    std::int32_t allocate(std::size_t count) {
+        std::size_t first = used.fetch_add(count, std::memory_order_relaxed);
+        return first + count <= capacity ? static_cast<std::int32_t>(first) : -1;
+    }
+    void reset() { used.store(0, std::memory_order_relaxed); }
+
+    MctsNode& operator[](std::int32_t index) { return nodes[index]; }
+    std::size_t size() const { return std::min(used.load(std::memory_order_relaxed), capacity); }
+    std::size_t bytes() const { return capacity * sizeof(MctsNode); }
+
+private:
+    std::unique_ptr<MctsNode[]> nodes;
+    std::size_t capacity;
+    std::atomic<std::size_t> used;
+};
+
+// Monte Carlo Tree Search over any HexBoard-like board, using tree parallelism: every worker
+// thread descends the same tree with UCT, expands leaves in place, and backs up the result of
+// a random playout run on its own copy of the board. Searches run asynchronously; the caller
+// starts one with a time budget and polls isFinished() (e.g. once per frame).
+template <class Board>
+class MctsEngine {
+public:
+    // threads == 0 uses every hardware thread except one, which is left for the caller
+    // (the render loop, in the game).
+    explicit MctsEngine(std::size_t maxNodes = 1 << 20, int threads = 0)
+        : arena(maxNodes),
+          threadCount(threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1)),
+          stopRequested(false),
+          finished(true),
+          playouts(0),
+          elapsedMicros(0),
+          chosenMove(-1),
+          chosenValue(0.5) {}
+
+    ~MctsEngine() { stop(); }
+
+    MctsEngine(const MctsEngine&) = delete;
+    MctsEngine& operator=(const MctsEngine&) = delete;
+
+    // Starts searching 'board' for 'player' in the background. Any running search is cancelled.
+    void startSearch(const Board& board, char player, double seconds) {
+        stop();
+        rootBoard.reset(new Board(board));
+        rootPlayer = player;
+        budget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+        arena.reset();
+        std::int32_t root = arena.allocate(1);
+        initNode(root, -1, 0);
+        playouts.store(0, std::memory_order_relaxed);
+        elapsedMicros.store(0, std::memory_order_relaxed);
+        chosenMove = -1;
+        chosenValue = 0.5;
+        stopRequested.store(false, std::memory_order_relaxed);
+        finished.store(false, std::memory_order_release);
+        controller = std::thread(&MctsEngine::runSearch, this);
+    }
+
+    // True once the budget has expired (or stop() was called) and a move has been chosen.
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+
+    // The chosen cell index, or -1 if no search has completed. Waits for a running search.
+    int bestMove() {
+        if (controller.joinable())
+            controller.join();
+        return chosenMove;
+    }
+
+    // Cancels a running search and waits for the workers to exit.
+    void stop() {
+        stopRequested.store(true, std::memory_order_relaxed);
+        if (controller.joinable())
+            controller.join();
+    }
+
+    // Blocking convenience wrapper around startSearch() / bestMove().
+    int search(const Board& board, char player, double seconds) {
+        startSearch(board, player, seconds);
+        return bestMove();
+    }
+
+    MctsStats stats() const {
+        MctsStats s;
+        s.playouts = playouts.load(std::memory_order_relaxed);
+        s.treeNodes = arena.size();
+        s.arenaBytes = arena.bytes();
+        s.seconds = elapsedMicros.load(std::memory_order_relaxed) / 1e6;
+        s.value = finished.load(std::memory_order_acquire) ? chosenValue : 0.5;
+        return s;
+    }
+
+    int threads() const { return threadCount; }
+
+private:
+    static const std::uint32_t EXPAND_THRESHOLD = 2;  // Visits before a leaf gets children
+    static constexpr double EXPLORATION = 1.4;
+
+    static char opponentOf(char player) { return player == 'X' ? 'O' : 'X'; }
+
+    void initNode(std::int32_t index, int move, std::uint8_t terminal) {
+        MctsNode &node = arena[index];
+        node.visits.store(0, std::memory_order_relaxed);
+        node.score.store(0, std::memory_order_relaxed);
+        node.firstChild.store(MctsNode::UNEXPANDED, std::memory_order_relaxed);
+        node.childCount = 0;
+        node.move = static_cast<std::int16_t>(move);
+        node.terminal = terminal;
+    }
+
+    // Creates one child per empty cell. Only the thread that wins the EXPANDING flag does the
+    // work; the children are fully initialised before firstChild is published.
+    bool expand(std::int32_t index, const Board& board, char player) {
+        MctsNode &node = arena[index];
+        std::int32_t expected = MctsNode::UNEXPANDED;
+        if (!node.firstChild.compare_exchange_strong(expected, MctsNode::EXPANDING, std::memory_order_acquire))
+            return false;
+        int count = board.cellCount() - board.moveCount();
+        std::int32_t first = count > 0 ? arena.allocate(count) : -1;
+        if (first < 0) {
+            node.firstChild.store(MctsNode::UNEXPANDED, std::memory_order_relaxed);
+            return false;
+        }
+        std::int32_t next = first;
+        for (int cell = 0; cell < board.cellCount(); cell++) {
+            if (board.valueAt(cell) != ' ')
+                continue;
+            Board after = board;
+            after.makeMoveAt(cell, player);
+            std::uint8_t terminal = after.checkWinnerAt(cell) == player ? 2 : (after.isFull() ? 1 : 0);
+            initNode(next++, cell, terminal);
+        }
+        node.childCount = count;
+        node.firstChild.store(first, std::memory_order_release);
+        return true;
+    }
+
+    // UCT child selection. Unvisited children are taken first.
+    std::int32_t select(std::int32_t index, std::uint32_t parentVisits) {
+        MctsNode &node = arena[index];
+        std::int32_t first = node.firstChild.load(std::memory_order_acquire);
+        double logParent = std::log(static_cast<double>(parentVisits) + 1.0);
+        std::int32_t best = first;
+        double bestValue = -1.0;
+        for (std::int32_t i = first; i < first + node.childCount; i++) {
+            MctsNode &child = arena[i];
+            std::uint32_t visits = child.visits.load(std::memory_order_relaxed);
+            if (visits == 0)
+                return i;
+            double mean = child.score.load(std::memory_order_relaxed) / (2.0 * visits);
+            double value = mean + EXPLORATION * std::sqrt(logParent / visits);
+            if (value > bestValue) {
+                bestValue = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Plays uniformly random moves to the end of the game; returns the winner or ' '.
+    static char playout(Board& board, char player, std::vector<int>& empty, std::uint64_t& rng) {
+        empty.clear();
+        for (int cell = 0; cell < board.cellCount(); cell++) {
+            if (board.valueAt(cell) == ' ')
+                empty.push_back(cell);
+        }
+        for (std::size_t n = empty.size(); n > 0; n--) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            std::size_t pick = rng % n;
+            int cell = empty[pick];
+            empty[pick] = empty[n - 1];
+            board.makeMoveAt(cell, player);
+            if (board.checkWinnerAt(cell) == player)
+                return player;
+            player = opponentOf(player);
+        }
+        return ' ';
+    }
+
+    void worker(unsigned seed) {
+        std::uint64_t rng = 0x9E3779B97F4A7C15ULL * (seed + 1);
+        std::vector<std::int32_t> path;
+        std::vector<int> empty;
+        auto deadline = startTime + budget;
+        for (unsigned iteration = 0; !stopRequested.load(std::memory_order_relaxed); iteration++) {
+            if ((iteration & 31) == 0 && std::chrono::steady_clock::now() >= deadline)
+                break;
+
+            Board board = *rootBoard;
+            char player = rootPlayer;
+            std::int32_t index = 0;
+            path.clear();
+            path.push_back(index);
+            std::uint32_t visits = arena[index].visits.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            // Descend while the node has children, applying virtual loss as we go.
+            while (arena[index].terminal == 0) {
+                if (arena[index].firstChild.load(std::memory_order_acquire) < 0) {
+                    if (visits < EXPAND_THRESHOLD || !expand(index, board, player))
+                        break;
+                }
+                index = select(index, visits);
+                visits = arena[index].visits.fetch_add(1, std::memory_order_relaxed) + 1;
+                board.makeMoveAt(arena[index].move, player);
+                player = opponentOf(player);
+                path.push_back(index);
+            }
+
+            // 'player' is now the side to move at the leaf; the leaf's mover is the other one.
+            char winner;
+            if (arena[index].terminal == 2)
+                winner = opponentOf(player);
+            else if (arena[index].terminal == 1)
+                winner = ' ';
+            else
+                winner = playout(board, player, empty, rng);
+
+            char mover = opponentOf(player);
+            for (std::size_t i = path.size(); i-- > 0;) {
+                std::uint32_t points = winner == ' ' ? 1 : (winner == mover ? 2 : 0);
+                if (points)
+                    arena[path[i]].score.fetch_add(points, std::memory_order_relaxed);
+                mover = opponentOf(mover);
+            }
+            playouts.fetch_add(1, std::memory_order_relaxed);
+            if ((iteration & 255) == 0)
+                publishElapsed();
+        }
+    }
+
+    void publishElapsed() {
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        elapsedMicros.store(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+                            std::memory_order_relaxed);
+    }
+
+    void runSearch() {
+        startTime = std::chrono::steady_clock::now();
+        std::vector<std::thread> helpers;
+        for (int i = 1; i < threadCount; i++)
+            helpers.emplace_back(&MctsEngine::worker, this, static_cast<unsigned>(i));
+        worker(0);
+        for (auto &helper : helpers)
+            helper.join();
+        publishElapsed();
+
+        // A move that wins on the spot beats any visit count; otherwise take the most-visited.
+        MctsNode &root = arena[0];
+        std::int32_t first = root.firstChild.load(std::memory_order_acquire);
+        std::int32_t best = -1;
+        for (std::int32_t i = first; first >= 0 && i < first + root.childCount; i++) {
+            if (arena[i].terminal == 2) {
+                best = i;
+                break;
+            }
+            if (best < 0 || arena[i].visits.load() > arena[best].visits.load())
+                best = i;
+        }
+        if (best >= 0) {
+            chosenMove = arena[best].move;
+            std::uint32_t visits = arena[best].visits.load(std::memory_order_relaxed);
+            if (arena[best].terminal)
+                chosenValue = arena[best].terminal / 2.0;
+            else if (visits > 0)
+                chosenValue = arena[best].score.load(std::memory_order_relaxed) / (2.0 * visits);
+        } else {
+            // Budget too small to expand the root: fall back to the first empty cell.
+            for (int cell = 0; cell < rootBoard->cellCount() && chosenMove < 0; cell++) {
+                if (rootBoard->valueAt(cell) == ' ')
+                    chosenMove = cell;
+            }
+        }
+#if HEX_TRACE_LEVEL >= HEX_TRACE_LEVEL_INFO
+        MctsStats summary = stats();
+        HEX_METRIC_ADD(metrics::searches, 1);
+        HEX_METRIC_ADD(metrics::playouts, static_cast<std::int64_t>(summary.playouts));
+        HEX_METRIC_SET(metrics::playoutsPerSecond, summary.playoutsPerSecond());
+        HEX_TRACE_INFO(TRACE_SEARCH, static_cast<std::int32_t>(std::min<std::uint64_t>(summary.playouts, INT32_MAX)),
+                       static_cast<std::int32_t>(summary.treeNodes), static_cast<std::int32_t>(summary.seconds * 1000),
+                       chosenMove);
+#endif
+        finished.store(true, std::memory_order_release);
+    }
+
+    MctsArena arena;
+    int threadCount;
+    std::unique_ptr<Board> rootBoard;
+    char rootPlayer;
+    std::chrono::steady_clock::duration budget;
+    std::chrono::steady_clock::time_point startTime;
+    std::thread controller;
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> finished;
+    std::atomic<std::uint64_t> playouts;
+    std::atomic<std::int64_t> elapsedMicros;
+    int chosenMove;
+    double chosenValue;   // See MctsStats::value; written before 'finished' is set
+};
+
+#endif
@@ -0,0 +1,111 @@
+// NetProtocol.h
+#ifndef NETPROTOCOL_H
+#define NETPROTOCOL_H
+
+#include "GameRecord.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Binary protocol between hex_server and its clients (the game with --connect, and
+// hex_loadgen). Every message is 4 bytes: u8 type, u8 argument, u16 value (little-endian),
+// so a read can never stop inside a variable-length field and a move costs one small write.
+//
+//   client -> server
+//     JOIN   arg k, value radius   queue for an opponent; leaves (forfeits) any current game
+//     MOVE   value cell            move for the client's side (cell index, see HexBoard)
+//   server -> client
+//     START  arg 'X' or 'O'        a game started; the argument is the client's side
+//     MOVED  arg GameResult, value cell
+//                                  a move was played; sent to both players, so the mover's
+//                                  copy is its acknowledgement
+//     END    arg NetEndReason      the game ended without a result
+//     ERROR  arg NetError          a request was rejected; the connection stays open
+
+const std::uint16_t HEX_SERVER_PORT = 4507;
+const std::size_t NET_MESSAGE_BYTES = 4;
+
+enum NetMessageType : std::uint8_t {
+    NET_JOIN = 1,
+    NET_MOVE = 2,
+    NET_START = 3,
+    NET_MOVED = 4,
+    NET_END = 5,
+    NET_ERROR = 6
+};
+
+enum NetEndReason : std::uint8_t {
+    NET_END_OPPONENT_LEFT = 1
+};
+
+enum NetError : std::uint8_t {
+    NET_ERROR_NONE = 0,
+    NET_ERROR_BAD_MESSAGE = 1,    // Unknown type
+    NET_ERROR_BAD_SIZE = 2,       // JOIN with an unsupported radius or win length
+    NET_ERROR_NOT_IN_GAME = 3,    // MOVE before START or after the game ended
+    NET_ERROR_NOT_YOUR_TURN = 4,
+    NET_ERROR_ILLEGAL_MOVE = 5    // Off the board or occupied
+};
+
+struct NetMessage {
+    NetMessageType type;
+    std::uint8_t arg;
+    std::uint16_t value;
+};
+
+inline void encodeNetMessage(const NetMessage& message, std::uint8_t* out) {
+    out[0] = message.type;
+    out[1] = message.arg;
+    out[2] = static_cast<std::uint8_t>(message.value);
+    out[3] = static_cast<std::uint8_t>(message.value >> 8);
+}
+
+inline NetMessage decodeNetMessage(const std::uint8_t* in) {
+    NetMessage message;
+    message.type = static_cast<NetMessageType>(in[0]);
+    message.arg = in[1];
+    message.value = static_cast<std::uint16_t>(in[2] | (in[3] << 8));
+    return message;
+}
+
+// Splits "host:port" (or just "host") into its parts. Returns false if the port is invalid.
+bool parseHostPort(const std::string& text, std::string& host, std::uint16_t& port);
+
+// Raises the soft limit on open files to the hard limit (a server or load generator needs one
+// descriptor per connection) and returns the new limit.
+long raiseOpenFileLimit();
+
+// Client side of one connection, used by the game's remote opponent. connect() blocks until
+// the connection is made; afterwards the socket is non-blocking and receive() returns only
+// the messages that have already arrived, so it can be polled once per frame.
+class NetClient {
+public:
+    NetClient();
+    ~NetClient();
+
+    NetClient(const NetClient&) = delete;
+    NetClient& operator=(const NetClient&) = delete;
+
+    // Returns false and sets 'error' if the server cannot be reached.
+    bool connect(const std::string& host, std::uint16_t port, std::string& error);
+    void close();
+    bool connected() const { return fd >= 0; }
+    // Hands the (non-blocking) socket over to the caller, who must close it.
+    int release();
+
+    // Queues and sends one message. Returns false (and closes) if the connection failed.
+    bool send(const NetMessage& message);
+    // Reads the next received message, if a whole one is available. Returns false when
+    // there is none; connected() tells whether the server has closed the connection.
+    bool receive(NetMessage& message);
+
+private:
+    bool fill();
+
+    int fd;
+    std::uint8_t buffer[256];
+    std::size_t start;   // First unread byte in 'buffer'
+    std::size_t end;     // One past the last received byte
+};
+
+#endif
@@ -0,0 +1,68 @@
+// ObjectPool.h
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Pool of T carved out of fixed-size chunks and addressed by 32-bit handles. A released
+// object is not destroyed: it goes on a free list and acquire() hands it out again as it is,
+// so anything it owns (a board's bit vectors, a move list's capacity) is reused as well and a
+// long-running server stops allocating once the pool has reached its peak size. Chunks never
+// move, so references stay valid while the pool grows.
+template <class T, std::size_t ChunkSize = 1024>
+class ObjectPool {
+public:
+    ObjectPool() : constructed(0) {}
+    ~ObjectPool() {
+        for (std::uint32_t i = 0; i < constructed; i++)
+            (*this)[i].~T();
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Returns the handle of a free object. A recycled object keeps its previous state; 'args'
+    // are only used when a new one has to be constructed.
+    template <class... Args>
+    std::uint32_t acquire(Args&&... args) {
+        if (!freeList.empty()) {
+            std::uint32_t handle = freeList.back();
+            freeList.pop_back();
+            return handle;
+        }
+        if (constructed == chunks.size() * ChunkSize)
+            chunks.emplace_back(new Slot[ChunkSize]);
+        std::uint32_t handle = constructed;
+        new (&slot(handle)) T(std::forward<Args>(args)...);
+        constructed++;
+        return handle;
+    }
+    void release(std::uint32_t handle) { freeList.push_back(handle); }
+
+    T& operator[](std::uint32_t handle) { return *reinterpret_cast<T*>(&slot(handle)); }
+    const T& operator[](std::uint32_t handle) const { return *reinterpret_cast<const T*>(&chunks[handle / ChunkSize][handle % ChunkSize]); }
+
+    // Objects currently handed out.
+    std::size_t size() const { return constructed - freeList.size(); }
+    // Objects ever constructed (the peak of size()).
+    std::size_t capacity() const { return constructed; }
+    // Memory held by the chunks, not counting what the objects themselves allocate.
+    std::size_t bytes() const { return chunks.size() * ChunkSize * sizeof(Slot); }
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+    Slot& slot(std::uint32_t handle) { return chunks[handle / ChunkSize][handle % ChunkSize]; }
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    std::vector<std::uint32_t> freeList;
+    std::uint32_t constructed;
+};
+
+#endif
@@ -0,0 +1,130 @@
+// PositionAnalyzer.h
+#ifndef POSITIONANALYZER_H
+#define POSITIONANALYZER_H
+
+#include "AlphaBetaSearch.h"
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int ANALYSIS_NO_SCORE = INT_MIN;  // Occupied cell, or one not scored yet
+
+// What the analyzer knows about one position: the value of every empty cell for the side to
+// move, from the deepest iteration that has finished.
+struct AnalysisSnapshot {
+    std::uint64_t sequence;   // Publication number; 0 until something has been published
+    std::uint64_t position;   // As returned by PositionAnalyzer::setPosition()
+    char toMove;
+    int depth;                // Plies searched per move in 'scores' (0: none finished yet)
+    bool finished;            // Nothing left to search: scores are exact, or the game is over
+    int bestMove;
+    std::uint64_t nodes;      // Searched for this position so far
+    double seconds;
+    std::vector<int> scores;  // Per cell, AlphaBetaSearch scores, or ANALYSIS_NO_SCORE
+
+    AnalysisSnapshot()
+        : sequence(0), position(0), toMove('X'), depth(0), finished(false), bestMove(-1), nodes(0), seconds(0) {}
+
+    double nodesPerSecond() const { return seconds > 0 ? nodes / seconds : 0.0; }
+};
+
+// Chance that the side to move wins after a move with the given score: 0 or 1 for a proven
+// result, otherwise a logistic curve on which two open lines one mark short of a win (the
+// usual winning threat) come to about 73%.
+double analysisWinProbability(int score, int winLength);
+
+// Background evaluation of every empty cell of a position, for the analysis overlay.
+//
+// A worker thread deepens one ply at a time, scoring each empty cell with a full-window
+// search (AlphaBetaSearch::scoreMove) in the order of the previous iteration, and publishes
+// a snapshot after each iteration and every PUBLISH_INTERVAL_MS in between. setPosition()
+// cancels the running search within a few thousand nodes. The transposition table is kept
+// from position to position, so after a move the worker starts from what it had already
+// searched below it, and cells are first ordered by their scores in the previous position.
+//
+// Snapshots reach the reader through a double buffer that needs no lock: one control word
+// holds the slot last published and the slot the reader is copying. The worker only writes
+// the slot the reader is not on; if the reader is still copying the older snapshot, the
+// worker keeps going and publishes at its next chance. One thread (the render loop) may read.
+class PositionAnalyzer {
+public:
+    static const int TABLE_BITS = 20;           // 16 MB transposition table
+    static const int PUBLISH_INTERVAL_MS = 100;
+
+    template <class Board>
+    explicit PositionAnalyzer(const Board& prototype)
+        : search(prototype, TABLE_BITS),
+          cells(prototype.cellCount()),
+          k(prototype.winLength()),
+          hasRequest(false),
+          stopping(false),
+          positions(0),
+          cancel(false),
+          control(0),
+          published(0),
+          hasUnpublished(false) {
+        start();
+    }
+    ~PositionAnalyzer();
+
+    // Starts analysing 'board' with 'toMove' to play, abandoning the previous position.
+    // Returns the number that snapshots of this position carry.
+    template <class Board>
+    std::uint64_t setPosition(const Board& board, char toMove) {
+        std::vector<char> values(cells);
+        for (int cell = 0; cell < cells; cell++)
+            values[cell] = board.valueAt(cell);
+        return post(values, toMove, board.checkWinner() != ' ' || board.isFull());
+    }
+    // Stops analysing until the next setPosition().
+    void pause();
+
+    // Copies the newest snapshot into 'out' if it differs from out.sequence. Never blocks.
+    bool latest(AnalysisSnapshot& out);
+
+    int winLength() const { return k; }
+
+private:
+    struct Request {
+        std::uint64_t position;
+        std::vector<char> values;
+        char toMove;
+        bool gameOver;
+    };
+
+    void start();
+    std::uint64_t post(const std::vector<char>& values, char toMove, bool gameOver);
+    void run();
+    void analyse(const Request& request);
+    // Publishes 'snapshot', or keeps a copy to retry if the reader is on the back slot.
+    bool publish(const AnalysisSnapshot& snapshot);
+    // Blocks until a request arrives (false: shutting down), retrying a deferred publish.
+    bool waitForRequest(Request& request);
+
+    AlphaBetaSearch search;   // Worker thread only
+    int cells;
+    int k;
+    std::vector<int> lastScores;  // Scores of the previous position, for move ordering
+
+    std::mutex requestLock;
+    std::condition_variable requestReady;
+    Request pending;
+    bool hasRequest;
+    bool stopping;
+    std::uint64_t positions;
+    std::atomic<bool> cancel;          // Set by setPosition() and pause(); polled by the search
+
+    AnalysisSnapshot slots[2];
+    std::atomic<unsigned> control;     // CONTROL_* bits, see PositionAnalyzer.cpp
+    std::uint64_t published;
+    AnalysisSnapshot unpublished;      // Deferred because the reader was on the back slot
+    bool hasUnpublished;
+
+    std::thread worker;
+};
+
+#endif
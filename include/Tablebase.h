@@ -0,0 +1,201 @@
+// Tablebase.h
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "HexSolver.h"
+#include "HexSymmetry.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Precomputed positions, written by hex_tablebase and memory-mapped by its readers. The file
+// is used in place, in host byte order (little-endian on every supported platform):
+//
+//   TablebaseHeader
+//   u32 displacement[buckets]    padded to a multiple of 8 bytes
+//   TablebaseEntry slot[slots]
+//
+// Positions are keyed as in HexSolver: one Zobrist hash per board symmetry, the smallest is
+// the key, so the 12 images of a position share an entry and its move is kept in that
+// canonical frame. Keys are placed with a CHD-style perfect hash: they are grouped into
+// buckets of about four, and each bucket stores the displacement that sends all of its keys
+// to distinct free slots. A lookup hashes the board, reads one displacement and one slot, and
+// compares the slot's check bits; there is no probing and nothing to parse when the file is
+// opened.
+
+const std::uint8_t TABLEBASE_VERSION = 1;
+const std::uint64_t TABLEBASE_KEY_SEED = 0x6865787474620001ULL;
+const char* const TABLEBASE_DEFAULT_PATH = "tablebase.hxtb";  // Written by hex_tablebase, read by the game
+
+// Value of a position for the side to move.
+enum TablebaseValue : std::uint8_t {
+    TB_EMPTY = 0,     // Unused slot
+    TB_WIN = 1,       // 'detail' = plies to the win with best play
+    TB_LOSS = 2,      // 'detail' = plies to the loss with best play
+    TB_DRAW = 3,      // 'detail' = plies until the board is full
+    TB_ESTIMATE = 4   // Not solved (partial tables): 'detail' = expected score * 255 (win 1, draw 1/2)
+};
+
+struct TablebaseEntry {
+    std::uint32_t check;   // High half of the key, to reject positions that are not in the table
+    std::uint16_t move;    // Best move, in the canonical frame
+    std::uint8_t value;    // TablebaseValue
+    std::uint8_t detail;
+};
+
+struct TablebaseHeader {
+    char magic[4];              // "HXTB"
+    std::uint8_t version;
+    std::uint8_t radius;
+    std::uint8_t winLength;
+    std::uint8_t complete;      // 1 if every reachable position is in the table
+    std::uint32_t depth;        // Reachable positions with fewer marks than this are in the table
+    std::uint32_t reserved;
+    std::uint64_t seed;         // Zobrist key seed
+    std::uint64_t entries;
+    std::uint64_t slots;
+    std::uint64_t buckets;
+};
+
+// A table entry as seen from the board that was looked up.
+struct TablebaseResult {
+    TablebaseValue value;
+    int plies;          // Exact values: plies until the game ends with best play
+    double score;       // Expected result for the side to move: 1 win, 0.5 draw, 0 loss
+    int bestMove;       // Cell index of the board that was looked up
+};
+
+// "X wins in 5", "draw in 4", "O scores 62%" and so on, for the side to move 'toMove'.
+std::string describeTablebaseResult(const TablebaseResult& result, char toMove);
+
+// The perfect hash: bucket from the low half of the key, slot from the whole key and the
+// bucket's displacement. Both are multiply-shift range reductions, not divisions.
+inline std::uint64_t tablebaseBucket(std::uint64_t key, std::uint64_t buckets) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key)) * buckets) >> 32;
+}
+inline std::uint64_t tablebaseSlot(std::uint64_t key, std::uint32_t displacement, std::uint64_t slots) {
+    std::uint64_t h = (key ^ (displacement * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+    return ((h >> 32) * slots) >> 32;
+}
+
+// Zobrist hashes of every symmetric image of a position. The generator and the readers build
+// it from the same seed, so they agree on keys. The keys a mark adds to the 12 images are
+// stored side by side, so a toggle is 12 consecutive XORs.
+class TablebaseHasher {
+public:
+    typedef std::array<std::uint64_t, HEX_SYMMETRY_COUNT> Hashes;
+
+    template <class Board>
+    TablebaseHasher(const Board& prototype, std::uint64_t seed)
+        : symmetries(prototype), cells(prototype.cellCount()), imageKeys(2 * HEX_SYMMETRY_COUNT * prototype.cellCount()) {
+        std::vector<std::uint64_t> keys(2 * cells);  // keys[cell] for 'X', keys[cells + cell] for 'O'
+        for (auto &key : keys)
+            key = splitMix64(seed);
+        for (int player = 0; player < 2; player++) {
+            for (int cell = 0; cell < cells; cell++) {
+                for (int s = 0; s < HEX_SYMMETRY_COUNT; s++)
+                    imageKeys[(player * cells + cell) * HEX_SYMMETRY_COUNT + s] = keys[player * cells + symmetries.map(s, cell)];
+            }
+        }
+    }
+
+    template <class Board>
+    void hash(const Board& board, Hashes& hashes) const {
+        hashes.fill(0);
+        for (int cell = 0; cell < cells; cell++) {
+            char value = board.valueAt(cell);
+            if (value != ' ')
+                toggle(hashes, cell, value);
+        }
+    }
+    // Adds (or removes) 'player' on 'cell' in every image.
+    void toggle(Hashes& hashes, int cell, char player) const {
+        const std::uint64_t* keys = &imageKeys[((player == 'X' ? 0 : cells) + cell) * HEX_SYMMETRY_COUNT];
+        for (int s = 0; s < HEX_SYMMETRY_COUNT; s++)
+            hashes[s] ^= keys[s];
+    }
+    // The symmetry whose image has the smallest hash; hashes[s] is the position's key.
+    static int canonicalSymmetry(const Hashes& hashes) {
+        return static_cast<int>(std::min_element(hashes.begin(), hashes.end()) - hashes.begin());
+    }
+    const HexSymmetries& symmetry() const { return symmetries; }
+
+private:
+    HexSymmetries symmetries;
+    int cells;
+    std::vector<std::uint64_t> imageKeys;  // [(player * cells + cell) * 12 + s], player 0 = 'X'
+};
+
+// One position for writeTablebase(); 'entry.check' is filled in by the writer.
+struct TablebaseRecord {
+    std::uint64_t key;
+    TablebaseEntry entry;
+};
+
+// Builds the perfect hash over 'records' (whose keys must be distinct) and writes the file.
+// Returns false and sets 'error' on failure.
+bool writeTablebase(const std::string& path, int radius, int k, int depth, bool complete,
+                    const std::vector<TablebaseRecord>& records, std::string& error);
+
+// Read-only, memory-mapped tablebase. Opening maps the file and checks its header; pages are
+// read in by the first lookups that touch them.
+class Tablebase {
+public:
+    Tablebase();
+    ~Tablebase();
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    // Returns false if the file does not exist ('error' left empty) or is not a usable
+    // tablebase ('error' set).
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    int radius() const { return header ? header->radius : -1; }
+    int winLength() const { return header ? header->winLength : 0; }
+    bool complete() const { return header && header->complete; }
+    int depth() const { return header ? static_cast<int>(header->depth) : 0; }
+    std::uint64_t entryCount() const { return header ? header->entries : 0; }
+    std::size_t bytes() const { return size; }
+
+    // The entry stored for a canonical key, or nullptr.
+    const TablebaseEntry* find(std::uint64_t key) const {
+        std::uint32_t displacement = displacements[tablebaseBucket(key, header->buckets)];
+        const TablebaseEntry& entry = slots[tablebaseSlot(key, displacement, header->slots)];
+        return entry.value != TB_EMPTY && entry.check == static_cast<std::uint32_t>(key >> 32) ? &entry : nullptr;
+    }
+
+    // Looks up 'board' (which must be of the table's size) with the side to move inferred
+    // from the move count. Returns false if the position is not in the table.
+    template <class Board>
+    bool probe(const Board& board, TablebaseResult& result) const {
+        if (!header || board.moveCount() >= depth())
+            return false;
+        TablebaseHasher::Hashes hashes;
+        hasher->hash(board, hashes);
+        int symmetry = TablebaseHasher::canonicalSymmetry(hashes);
+        const TablebaseEntry* entry = find(hashes[symmetry]);
+        if (!entry)
+            return false;
+        result = resultFor(*entry, hasher->symmetry().unmap(symmetry, entry->move));
+        return true;
+    }
+
+    // An entry as a result, with its move already mapped to the caller's frame.
+    static TablebaseResult resultFor(const TablebaseEntry& entry, int move);
+
+private:
+    const TablebaseHeader* header;
+    const std::uint32_t* displacements;
+    const TablebaseEntry* slots;
+    std::size_t size;
+    std::unique_ptr<TablebaseHasher> hasher;
+};
+
+#endif
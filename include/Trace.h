@@ -0,0 +1,220 @@
+// Trace.h
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Compile-time trace level (set with -DHEX_TRACE_LEVEL=n; CMake exposes it as a cache
+// variable). Events above the level are removed by the preprocessor, arguments included, and
+// at HEX_TRACE_LEVEL_OFF the metric macros are empty too.
+#define HEX_TRACE_LEVEL_OFF 0
+#define HEX_TRACE_LEVEL_INFO 1   // Moves, results, resets, settings, searches
+#define HEX_TRACE_LEVEL_DEBUG 2  // Adds one event per frame
+#ifndef HEX_TRACE_LEVEL
+#define HEX_TRACE_LEVEL HEX_TRACE_LEVEL_INFO
+#endif
+
+// Event kinds and the meaning of their arguments.
+enum TraceEventType : std::uint16_t {
+    TRACE_MOVE = 1,      // cell index, player, q, r
+    TRACE_GAME_OVER,     // winner ('X', 'O', or 'D' for a draw), moves played
+    TRACE_RESET,         // moves played in the abandoned game
+    TRACE_BACKGROUND,    // 1 = white, 0 = black
+    TRACE_AI,            // 1 = computer opponent enabled
+    TRACE_PACING,        // 1 = capped, 0 = event-driven
+    TRACE_FRAME,         // event handling µs, draw µs, 1 if a frame was drawn
+    TRACE_SEARCH,        // playouts, tree nodes, milliseconds, best move
+    TRACE_SOLVE,         // nodes (saturated), milliseconds, score, best move
+    TRACE_TABLEBASE,     // entries (saturated), microseconds to open, 1 if complete
+    TRACE_STARTUP,       // µs to the first frame, µs loading fonts, µs warming glyphs, glyphs warmed
+    TRACE_ANALYSIS       // 1 = analysis overlay enabled
+};
+
+// One fixed-size, structured event. Arguments are interpreted per TraceEventType.
+struct TraceEvent {
+    std::uint64_t nanos;     // Since Tracer::start()
+    std::uint16_t type;      // TraceEventType
+    std::uint16_t thread;    // Buffer (thread) that recorded the event
+    std::int32_t args[5];
+};
+
+// Formats one event as a line of text (no newline). Returns the length written.
+int formatTraceEvent(const TraceEvent& event, char* out, std::size_t size);
+
+// Destination for drained events. Called only from the drain thread.
+class TraceSink {
+public:
+    virtual ~TraceSink() {}
+    virtual void write(const TraceEvent* events, std::size_t count) = 0;
+    virtual void flush() {}
+};
+
+// Writes one line per event (see formatTraceEvent).
+class TextTraceSink : public TraceSink {
+public:
+    explicit TextTraceSink(std::FILE* out) : out(out) {}
+    virtual void write(const TraceEvent* events, std::size_t count);
+    virtual void flush() { std::fflush(out); }
+private:
+    std::FILE* out;
+};
+
+// Writes "HXTR", a version byte, a reserved byte and the u16 event size, then the raw
+// TraceEvent structs in host byte order.
+class BinaryTraceSink : public TraceSink {
+public:
+    explicit BinaryTraceSink(const std::string& path);
+    virtual ~BinaryTraceSink();
+    virtual void write(const TraceEvent* events, std::size_t count);
+    virtual void flush();
+    bool good() const { return file != nullptr; }
+private:
+    std::FILE* file;
+};
+
+// Single-producer, single-consumer ring of events. The producer is the thread that owns the
+// buffer; the consumer is the drain thread. A full buffer drops new events (and counts them)
+// rather than making the producer wait.
+class TraceBuffer {
+public:
+    static const std::size_t CAPACITY = 4096;  // Power of two
+
+    explicit TraceBuffer(std::uint16_t id) : id(id), head(0), cachedTail(0), tail(0), dropped(0), retired(false) {}
+
+    bool push(TraceEvent event) {
+        std::uint64_t position = head.load(std::memory_order_relaxed);
+        if (position - cachedTail >= CAPACITY) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position - cachedTail >= CAPACITY) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        event.thread = id;
+        events[position & (CAPACITY - 1)] = event;
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: appends every published event to 'out'.
+    void drain(std::vector<TraceEvent>& out) {
+        std::uint64_t position = tail.load(std::memory_order_relaxed);
+        std::uint64_t end = head.load(std::memory_order_acquire);
+        for (; position != end; position++)
+            out.push_back(events[position & (CAPACITY - 1)]);
+        tail.store(position, std::memory_order_release);
+    }
+
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    // Called by the owning thread as it exits.
+    void retire() { retired.store(true, std::memory_order_release); }
+
+    const std::uint16_t id;
+
+private:
+    friend class Tracer;
+
+    // Producer and consumer positions live on separate cache lines.
+    alignas(64) std::atomic<std::uint64_t> head;
+    std::uint64_t cachedTail;                    // Producer's last view of 'tail'
+    alignas(64) std::atomic<std::uint64_t> tail;
+    alignas(64) std::atomic<std::uint64_t> dropped;
+    std::atomic<bool> retired;                   // Owning thread has exited; reusable once drained
+    TraceEvent events[CAPACITY];
+};
+
+// Process-wide tracer. Each thread records into its own TraceBuffer, registered on its first
+// event; a background thread drains every buffer at a fixed interval, orders the batch by
+// time and hands it to the sink. Until start() (or after stop()) emitting is a single relaxed
+// load, so the engine and tools can be traced or not without changes.
+class Tracer {
+public:
+    static void start(std::unique_ptr<TraceSink> sink,
+                      std::chrono::milliseconds interval = std::chrono::milliseconds(50));
+    // Drains what is left, stops the drain thread and releases the sink.
+    static void stop();
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    static void emit(TraceEventType type, std::int32_t a = 0, std::int32_t b = 0, std::int32_t c = 0,
+                     std::int32_t d = 0, std::int32_t e = 0);
+    // Events lost to full buffers since the process started.
+    static std::uint64_t droppedEvents();
+
+private:
+    static std::atomic<bool> active;
+};
+
+// Monotonic count, safe to bump from any thread. Bump it once per batch of work inside
+// multi-threaded loops; every add is an atomic read-modify-write on a shared line.
+class MetricCounter {
+public:
+    explicit MetricCounter(const char* name);
+    void add(std::int64_t n = 1) { count.fetch_add(n, std::memory_order_relaxed); }
+    std::int64_t get() const { return count.load(std::memory_order_relaxed); }
+    const char* name() const { return label; }
+private:
+    const char* label;
+    std::atomic<std::int64_t> count;
+};
+
+// Last-written value.
+class MetricGauge {
+public:
+    explicit MetricGauge(const char* name);
+    void set(double value) { current.store(value, std::memory_order_relaxed); }
+    double get() const { return current.load(std::memory_order_relaxed); }
+    const char* name() const { return label; }
+private:
+    const char* label;
+    std::atomic<double> current;
+};
+
+struct MetricValue {
+    std::string name;
+    double value;
+};
+
+// Runtime view of every counter and gauge.
+class Metrics {
+public:
+    static std::vector<MetricValue> snapshot();
+    // "name=value" pairs separated by spaces, in registration order.
+    static std::string summary();
+};
+
+// Metrics shared across modules.
+namespace metrics {
+extern MetricCounter movesPlayed;        // game.moves
+extern MetricCounter gamesFinished;      // game.finished
+extern MetricCounter searches;           // mcts.searches
+extern MetricCounter playouts;           // mcts.playouts
+extern MetricCounter solverNodes;        // solver.nodes
+extern MetricCounter tablebaseHits;      // tablebase.hits (moves answered without a search)
+extern MetricGauge playoutsPerSecond;    // mcts.playouts_per_sec (last search)
+extern MetricGauge frameDrawMicros;      // frame.draw_us (last frame drawn)
+extern MetricGauge firstFrameMillis;     // startup.first_frame_ms (game created to first frame shown)
+}
+
+#if HEX_TRACE_LEVEL >= HEX_TRACE_LEVEL_INFO
+#define HEX_TRACE_INFO(...) do { if (Tracer::enabled()) Tracer::emit(__VA_ARGS__); } while (0)
+#define HEX_METRIC_ADD(counter, n) (counter).add(n)
+#define HEX_METRIC_SET(gauge, value) (gauge).set(value)
+#else
+#define HEX_TRACE_INFO(...) ((void)0)
+#define HEX_METRIC_ADD(counter, n) ((void)0)
+#define HEX_METRIC_SET(gauge, value) ((void)0)
+#endif
+
+#if HEX_TRACE_LEVEL >= HEX_TRACE_LEVEL_DEBUG
+#define HEX_TRACE_DEBUG(...) do { if (Tracer::enabled()) Tracer::emit(__VA_ARGS__); } while (0)
+#else
+#define HEX_TRACE_DEBUG(...) ((void)0)
+#endif
+
+#endif
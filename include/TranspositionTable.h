@@ -0,0 +1,59 @@
+// TranspositionTable.h
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bound stored with a transposition-table score.
+enum TTBound : std::uint8_t {
+    TT_NONE = 0,
+    TT_EXACT = 1,
+    TT_LOWER = 2,  // score is a lower bound (search failed high)
+    TT_UPPER = 3   // score is an upper bound (search failed low)
+};
+
+// One 16-byte slot. 'depth' is the number of empty cells below the position, which is
+// the best available proxy for how much work the stored result saved.
+struct TTEntry {
+    std::uint64_t key;
+    std::int16_t score;
+    std::int16_t move;
+    std::uint8_t bound;
+    std::uint8_t depth;
+    std::uint8_t generation;
+    std::uint8_t padding;
+};
+
+// Fixed-size, cache-line-aligned hash table of search results. Each 64-byte bucket holds
+// four entries; a store overwrites the entry with the same key, otherwise the entry from an
+// older search or, failing that, the one with the smallest depth.
+class TranspositionTable {
+public:
+    static const int BUCKET_SIZE = 4;
+
+    explicit TranspositionTable(std::size_t megabytes);
+
+    // Returns the entry stored for 'key', or nullptr.
+    const TTEntry* probe(std::uint64_t key) const;
+    void store(std::uint64_t key, int score, int move, TTBound bound, int depth);
+
+    // Marks subsequent stores as belonging to a new search, so older entries are replaced first.
+    void newSearch() { generation++; }
+    void clear();
+
+    std::size_t entryCount() const { return buckets.size() * BUCKET_SIZE; }
+    std::size_t bytes() const { return buckets.size() * sizeof(Bucket); }
+
+private:
+    struct alignas(64) Bucket {
+        TTEntry entries[BUCKET_SIZE];
+    };
+
+    std::vector<Bucket> buckets;
+    std::uint64_t mask;
+    std::uint8_t generation;
+};
+
+#endif
@@ -5,8 +5,48 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 
+// Fonts available to UI text.
+enum UIFont {
+    FONT_STANDARD,  // Sans-serif font for general UI text
+    FONT_CURSIVE    // Cursive font for the winner text
+};
+
+// Character sizes the game draws text at.
+const int TEXT_SIZE_SMALL = 18;    // Status lines and the signature
+const int TEXT_SIZE_PROMPT = 28;   // Prompts and the timer
+const int TEXT_SIZE_TURN = 36;     // Turn indicator
+const int TEXT_SIZE_TITLE = 42;    // Title
+const int TEXT_SIZE_WINNER = 48;   // Winner text, in FONT_CURSIVE
+
+// Every (font, size) pair above: UI::loadFonts() renders their glyphs ahead of time.
+struct UITextStyle {
+    UIFont font;
+    int size;
+};
+const UITextStyle UI_TEXT_STYLES[] = {
+    {FONT_STANDARD, TEXT_SIZE_SMALL}, {FONT_STANDARD, TEXT_SIZE_PROMPT}, {FONT_STANDARD, TEXT_SIZE_TURN},
+    {FONT_STANDARD, TEXT_SIZE_TITLE}, {FONT_CURSIVE, TEXT_SIZE_WINNER}
+};
+
+// What the first UI::loadFonts() call cost.
+struct FontLoadStats {
+    bool loaded;          // Both fonts loaded
+    double loadSeconds;   // Parsing the font files
+    double warmSeconds;   // Rendering glyphs into the atlases
+    int glyphs;           // Glyphs rendered
+};
+
 class UI {
 public:
+    // Loads both fonts (compiled into the binary in CMake builds, otherwise read from assets/)
+    // and renders the printable ASCII glyphs of every UI_TEXT_STYLES entry, so the first frames
+    // do not stall rasterizing text. Only the first call does any work; the game calls it at
+    // startup. Returns false if a font could not be loaded.
+    static bool loadFonts();
+    static const FontLoadStats& fontLoadStats();
+    // Returns the requested font (calling loadFonts() if nothing has yet).
+    static const sf::Font& font(UIFont id);
+
     // Draws centered text at the given (centerX, centerY) using the standard font.
     // The optional 'scale' parameter (default 1.0) allows animated scaling.
     static void drawText(sf::RenderWindow& window, const std::string& text,
@@ -17,4 +57,35 @@ public:
                                int centerX, int centerY, int size, sf::Color color, float scale = 1.0f);
 };
 
+// Retained, centered text with a drop shadow. The laid-out text and its shadow are kept
+// between frames and only rebuilt when the content key (string, font, size, color) changes;
+// position and scale are applied as a transform at draw time, so moving or animating a
+// label never re-lays out its glyphs.
+class TextLabel : public sf::Drawable {
+public:
+    TextLabel();
+
+    // Updates the content. Returns true if the label had to be laid out again.
+    bool setContent(const std::string& text, UIFont font, int size, sf::Color color);
+    // Places the center of the text at (x, y).
+    void setCenter(float x, float y) { placement.setPosition(x, y); }
+    void setScale(float scale) { placement.setScale(scale, scale); }
+
+    const std::string& getString() const { return text; }
+    // Number of times this label has been laid out (for frame profiling).
+    unsigned layoutCount() const { return layouts; }
+
+private:
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+    std::string text;
+    UIFont fontId;
+    int size;
+    sf::Color color;
+    sf::Text label;
+    sf::Text shadow;
+    sf::Transformable placement;
+    unsigned layouts;
+};
+
 #endif
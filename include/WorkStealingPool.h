@@ -0,0 +1,70 @@
+// WorkStealingPool.h
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker runs its newest task
+// first (LIFO, so a task that splits itself keeps working on warm data) and, when its deque is
+// empty, steals the oldest task of another worker (which, for split ranges, is the largest
+// piece left). Tasks receive the index of the worker running them, so callers can keep
+// per-worker state (output buffers, boards, RNGs) in a plain vector without locking.
+class WorkStealingPool {
+public:
+    typedef std::function<void(int worker)> Task;
+    typedef std::function<void(std::size_t begin, std::size_t end, int worker)> RangeTask;
+
+    // threads <= 0 uses every hardware thread.
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const { return static_cast<int>(queues.size()); }
+
+    // Queues a task. From inside a task it goes to the running worker's own deque; from any
+    // other thread the deques are filled in turn.
+    void submit(Task task);
+    // Blocks until every submitted task, including the ones tasks submitted, has finished.
+    // Must not be called from inside a task.
+    void wait();
+    // Runs fn over [0, count) in pieces of at most 'grain' indices and waits for them. The
+    // range is halved on the fly, so idle workers steal big pieces and split them further.
+    void parallelFor(std::size_t count, std::size_t grain, const RangeTask& fn);
+
+    // Tasks taken from another worker's deque since the pool was created.
+    std::uint64_t steals() const { return stolen.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(int worker);
+    bool takeTask(int worker, Task& task);
+    void splitRange(std::size_t begin, std::size_t end, std::size_t grain, const RangeTask* fn, int worker);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> queued;    // Tasks sitting in a deque
+    std::atomic<std::size_t> pending;   // Tasks submitted and not yet finished
+    std::atomic<std::size_t> nextQueue; // Round robin for submissions from outside the pool
+    std::atomic<std::uint64_t> stolen;
+    std::mutex sleepLock;
+    std::condition_variable wake;       // Workers wait here when every deque is empty
+    std::condition_variable idle;       // wait() waits here for 'pending' to reach zero
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,283 @@
+// AlphaBetaSearch.cpp
+#include "AlphaBetaSearch.h"
+#include "HexSolver.h"
+
+namespace {
+
+const int STOP_POLL_NODES = 1024;   // Nodes between checks of the stop flag
+
+inline int sideOf(char player) {
+    return player == 'X' ? 0 : 1;
+}
+
+// Win/loss scores are stored relative to the node, as in HexSolver, so they stay valid at
+// any ply.
+inline int toTable(int score, int ply) {
+    return score > ALPHABETA_WIN_THRESHOLD ? score + ply : (score < -ALPHABETA_WIN_THRESHOLD ? score - ply : score);
+}
+inline int fromTable(int score, int ply) {
+    return score > ALPHABETA_WIN_THRESHOLD ? score - ply : (score < -ALPHABETA_WIN_THRESHOLD ? score + ply : score);
+}
+
+} // namespace
+
+void AlphaBetaSearch::build(const std::vector<int>& lineCells, const std::vector<std::vector<int>>& near, int tableBits) {
+    // An open line with n marks is worth 8^(n - 1), capped so a sum over every line of a
+    // large board stays clear of the win scores.
+    weights.assign(k + 1, 0);
+    for (int n = 1; n <= k; n++)
+        weights[n] = 1LL << std::min(3 * (n - 1), 24);
+
+    int lines = static_cast<int>(lineCells.size()) / k;
+    cellLineStart.assign(cells + 1, 0);
+    for (int cell : lineCells)
+        cellLineStart[cell + 1]++;
+    for (int cell = 0; cell < cells; cell++)
+        cellLineStart[cell + 1] += cellLineStart[cell];
+    cellLines.resize(lineCells.size());
+    std::vector<int> fill(cellLineStart.begin(), cellLineStart.end() - 1);
+    for (int line = 0; line < lines; line++) {
+        for (int i = 0; i < k; i++)
+            cellLines[fill[lineCells[line * k + i]]++] = line;
+    }
+
+    nearStart.assign(1, 0);
+    for (const auto &list : near) {
+        nearCells.insert(nearCells.end(), list.begin(), list.end());
+        nearStart.push_back(static_cast<int>(nearCells.size()));
+    }
+
+    values.resize(cells);
+    xCount.resize(lines);
+    oCount.resize(lines);
+    nearCount.resize(cells);
+
+    std::uint64_t seed = 0x6865787474740002ULL;
+    zobrist.resize(2 * cells);
+    for (auto &key : zobrist)
+        key = splitMix64(seed);
+    sideKey = splitMix64(seed);
+    table.assign(tableBits > 0 ? std::size_t(1) << tableBits : 0, TableEntry{0, 0, -1, TT_NONE, 0});
+    tableMask = tableBits > 0 ? (std::uint64_t(1) << tableBits) - 2 : 0;
+    clear();
+}
+
+void AlphaBetaSearch::clear() {
+    std::fill(values.begin(), values.end(), ' ');
+    std::fill(xCount.begin(), xCount.end(), 0);
+    std::fill(oCount.begin(), oCount.end(), 0);
+    std::fill(nearCount.begin(), nearCount.end(), 0);
+    threats[0] = threats[1] = 0;
+    xScore = 0;
+    placed = 0;
+    hash = 0;
+}
+
+long long AlphaBetaSearch::lineScore(int line) const {
+    if (oCount[line] == 0)
+        return weights[xCount[line]];
+    return xCount[line] == 0 ? -weights[oCount[line]] : 0;
+}
+
+void AlphaBetaSearch::play(int cell, char player) {
+    std::vector<int>& mine = player == 'X' ? xCount : oCount;
+    const std::vector<int>& theirs = player == 'X' ? oCount : xCount;
+    int side = sideOf(player);
+    for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+        int line = cellLines[i];
+        xScore -= lineScore(line);
+        // Open threats before the move: the mover's may grow into one (or a win), and the
+        // opponent's is blocked.
+        if (theirs[line] == k - 1 && mine[line] == 0)
+            threats[1 - side]--;
+        if (mine[line] == k - 1 && theirs[line] == 0)
+            threats[side]--;
+        mine[line]++;
+        if (mine[line] == k - 1 && theirs[line] == 0)
+            threats[side]++;
+        xScore += lineScore(line);
+    }
+    for (int i = nearStart[cell]; i < nearStart[cell + 1]; i++)
+        nearCount[nearCells[i]]++;
+    values[cell] = player;
+    placed++;
+    hash ^= zobrist[side * cells + cell];
+}
+
+void AlphaBetaSearch::undo(int cell, char player) {
+    std::vector<int>& mine = player == 'X' ? xCount : oCount;
+    const std::vector<int>& theirs = player == 'X' ? oCount : xCount;
+    int side = sideOf(player);
+    for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+        int line = cellLines[i];
+        xScore -= lineScore(line);
+        if (mine[line] == k - 1 && theirs[line] == 0)
+            threats[side]--;
+        mine[line]--;
+        if (mine[line] == k - 1 && theirs[line] == 0)
+            threats[side]++;
+        if (theirs[line] == k - 1 && mine[line] == 0)
+            threats[1 - side]++;
+        xScore += lineScore(line);
+    }
+    for (int i = nearStart[cell]; i < nearStart[cell + 1]; i++)
+        nearCount[nearCells[i]]--;
+    values[cell] = ' ';
+    placed--;
+    hash ^= zobrist[side * cells + cell];
+}
+
+const AlphaBetaSearch::TableEntry* AlphaBetaSearch::probe(std::uint64_t key) const {
+    if (table.empty())
+        return nullptr;
+    const TableEntry* bucket = &table[key & tableMask];
+    for (int i = 0; i < 2; i++) {
+        if (bucket[i].bound != TT_NONE && bucket[i].key == key)
+            return &bucket[i];
+    }
+    return nullptr;
+}
+
+void AlphaBetaSearch::store(std::uint64_t key, int score, int move, TTBound bound, int depth) {
+    if (table.empty())
+        return;
+    TableEntry* bucket = &table[key & tableMask];
+    depth = std::min(depth, 255);
+    TableEntry& entry = (bucket[0].key == key || depth >= bucket[0].depth) ? bucket[0] : bucket[1];
+    entry = TableEntry{key, score, static_cast<std::int16_t>(move), static_cast<std::uint8_t>(bound),
+                       static_cast<std::uint8_t>(depth)};
+}
+
+int AlphaBetaSearch::evaluate(char player) const {
+    long long clamped = std::max<long long>(-(ALPHABETA_WIN_THRESHOLD - 1), std::min<long long>(ALPHABETA_WIN_THRESHOLD - 1, xScore));
+    return static_cast<int>(player == 'X' ? clamped : -clamped);
+}
+
+int AlphaBetaSearch::generate(char player, std::vector<Candidate>& moves) const {
+    const std::vector<int>& mine = player == 'X' ? xCount : oCount;
+    const std::vector<int>& theirs = player == 'X' ? oCount : xCount;
+    bool wide = cells > FULL_WIDTH_CELLS;
+    moves.clear();
+    for (int cell = 0; cell < cells; cell++) {
+        if (values[cell] != ' ')
+            continue;
+        if (wide && (placed > 0 ? nearCount[cell] == 0 : centreDistance[cell] > 0))
+            continue;
+        // How much the move changes the evaluation for the mover: it extends its own open
+        // lines and closes the opponent's.
+        long long gain = 0;
+        for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+            int line = cellLines[i];
+            if (theirs[line] == 0) {
+                if (mine[line] == k - 1)
+                    return cell;
+                gain += weights[mine[line] + 1] - weights[mine[line]];
+            } else if (mine[line] == 0) {
+                gain += weights[theirs[line]];
+            }
+        }
+        moves.push_back(Candidate{cell, gain * 256 - centreDistance[cell]});
+    }
+    std::sort(moves.begin(), moves.end(), [](const Candidate& a, const Candidate& b) { return a.order > b.order; });
+    return -1;
+}
+
+int AlphaBetaSearch::negamax(char player, int depth, int alpha, int beta, int ply, int* bestMoveOut) {
+    nodes++;
+    if (stopFlag && nodes % STOP_POLL_NODES == 0 && stopFlag->load(std::memory_order_relaxed))
+        halted = true;
+    if (halted)
+        return 0;
+    // At the horizon, an open line the side to move can complete is still a win.
+    if (depth == 0)
+        return threats[sideOf(player)] > 0 ? ALPHABETA_WIN_SCORE - (ply + 1) : evaluate(player);
+
+    std::vector<Candidate>& moves = moveBuffers[ply];
+    int win = generate(player, moves);
+    if (win >= 0) {
+        if (bestMoveOut)
+            *bestMoveOut = win;
+        return ALPHABETA_WIN_SCORE - (ply + 1);
+    }
+    if (moves.empty())
+        return evaluate(player);
+
+    std::uint64_t key = keyFor(player);
+    if (const TableEntry* entry = probe(key)) {
+        int score = fromTable(entry->score, ply);
+        if (!bestMoveOut && entry->depth >= depth) {
+            if (entry->bound == TT_EXACT)
+                return score;
+            if (entry->bound == TT_LOWER && score >= beta)
+                return score;
+            if (entry->bound == TT_UPPER && score <= alpha)
+                return score;
+        }
+        // The stored best move goes first, ahead of the static ordering.
+        for (std::size_t i = 1; i < moves.size(); i++) {
+            if (moves[i].cell == entry->move) {
+                std::rotate(moves.begin(), moves.begin() + i, moves.begin() + i + 1);
+                break;
+            }
+        }
+    }
+
+    char opponent = player == 'X' ? 'O' : 'X';
+    int originalAlpha = alpha;
+    int bestScore = -ALPHABETA_WIN_SCORE - 1;
+    int bestMove = -1;
+    for (const Candidate& move : moves) {
+        play(move.cell, player);
+        int score = placed == cells ? 0 : -negamax(opponent, depth - 1, -beta, -alpha, ply + 1, nullptr);
+        undo(move.cell, player);
+        if (halted)
+            return 0;
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move.cell;
+        }
+        if (score > alpha)
+            alpha = score;
+        if (alpha >= beta)
+            break;
+    }
+    TTBound bound = bestScore <= originalAlpha ? TT_UPPER : (bestScore >= beta ? TT_LOWER : TT_EXACT);
+    store(key, toTable(bestScore, ply), bestMove, bound, depth);
+    if (bestMoveOut)
+        *bestMoveOut = bestMove;
+    return bestScore;
+}
+
+AlphaBetaResult AlphaBetaSearch::search(char player, int depth) {
+    depth = std::max(depth, 1);
+    if (moveBuffers.size() < static_cast<std::size_t>(depth) + 1)
+        moveBuffers.resize(depth + 1);
+    halted = false;
+    std::uint64_t start = nodes;
+    AlphaBetaResult result;
+    result.bestMove = -1;
+    result.score = negamax(player, depth, -ALPHABETA_WIN_SCORE - 1, ALPHABETA_WIN_SCORE + 1, 0, &result.bestMove);
+    if (halted)
+        result.bestMove = -1;
+    result.nodes = nodes - start;
+    return result;
+}
+
+int AlphaBetaSearch::scoreMove(char player, int cell, int depth) {
+    depth = std::max(depth, 1);
+    if (moveBuffers.size() < static_cast<std::size_t>(depth) + 1)
+        moveBuffers.resize(depth + 1);
+    halted = false;
+    const std::vector<int>& mine = player == 'X' ? xCount : oCount;
+    const std::vector<int>& theirs = player == 'X' ? oCount : xCount;
+    for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+        if (mine[cellLines[i]] == k - 1 && theirs[cellLines[i]] == 0)
+            return ALPHABETA_WIN_SCORE - 1;
+    }
+    nodes++;
+    play(cell, player);
+    int score = placed == cells ? 0
+              : -negamax(player == 'X' ? 'O' : 'X', depth - 1, -ALPHABETA_WIN_SCORE - 1, ALPHABETA_WIN_SCORE + 1, 1, nullptr);
+    undo(cell, player);
+    return score;
+}
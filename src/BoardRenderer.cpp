@@ -0,0 +1,179 @@
+// BoardRenderer.cpp
+#include "BoardRenderer.h"
+#include <cmath>
+#include <string>
+
+namespace {
+
+const float OUTLINE_THICKNESS = 2.0f;
+const sf::Color HOVER_COLOR(255, 236, 160);  // Pale yellow tint for the empty cell under the pointer
+const float HEAT_RADIUS = HEX_SIZE * 0.85f;  // Heat hexagons leave a rim of the cell showing
+const sf::Uint8 HEAT_ALPHA = 190;
+const sf::Color HEAT_LOSS(200, 40, 40);
+const sf::Color HEAT_EVEN(235, 200, 40);
+const sf::Color HEAT_WIN(30, 160, 60);
+
+// Corner i of a flat-topped hexagon of the given radius, centred at 'center'.
+sf::Vector2f hexCorner(const sf::Vector2f& center, float radius, int i) {
+    float angle = 3.14159265f / 3.0f * i;
+    return sf::Vector2f(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+}
+
+sf::Color blend(const sf::Color& a, const sf::Color& b, double t) {
+    return sf::Color(static_cast<sf::Uint8>(a.r + (b.r - a.r) * t),
+                     static_cast<sf::Uint8>(a.g + (b.g - a.g) * t),
+                     static_cast<sf::Uint8>(a.b + (b.b - a.b) * t), HEAT_ALPHA);
+}
+
+// Red at 0, yellow at 0.5, green at 1.
+sf::Color heatColor(double winProbability) {
+    if (winProbability < 0.5)
+        return blend(HEAT_LOSS, HEAT_EVEN, winProbability * 2);
+    return blend(HEAT_EVEN, HEAT_WIN, (winProbability - 0.5) * 2);
+}
+
+std::string analysisLabel(int score, bool exact, int winLength) {
+    if (score > ALPHABETA_WIN_THRESHOLD)
+        return "W" + std::to_string(ALPHABETA_WIN_SCORE - score);
+    if (score < -ALPHABETA_WIN_THRESHOLD)
+        return "L" + std::to_string(ALPHABETA_WIN_SCORE + score);
+    if (exact)
+        return "=";
+    return std::to_string(static_cast<int>(std::lround(analysisWinProbability(score, winLength) * 100))) + "%";
+}
+
+} // namespace
+
+BoardRenderer::BoardRenderer() : vertices(sf::Triangles), hoveredCell(-1) {
+}
+
+void BoardRenderer::beginBuild(int cellCount) {
+    vertices.clear();
+    outlines.clear();
+    values.assign(cellCount, ' ');
+    hoveredCell = -1;
+}
+
+void BoardRenderer::addCell(const HexCell& cell) {
+    sf::Vector2f center = hexAxialToPixel(cell.q, cell.r);
+    sf::Color fill = fillColorFor(-1, cell.value);
+    // Like an sf::CircleShape outline, the border sits outside the fill; pushing each edge
+    // out by the thickness moves the corners out by thickness / cos(30°).
+    float outer = HEX_SIZE + OUTLINE_THICKNESS / std::cos(3.14159265f / 6.0f);
+    for (int i = 0; i < 6; i++) {
+        sf::Vector2f a = hexCorner(center, HEX_SIZE, i);
+        sf::Vector2f b = hexCorner(center, HEX_SIZE, (i + 1) % 6);
+        vertices.append(sf::Vertex(center, fill));
+        vertices.append(sf::Vertex(a, fill));
+        vertices.append(sf::Vertex(b, fill));
+
+        sf::Vector2f outerA = hexCorner(center, outer, i);
+        sf::Vector2f outerB = hexCorner(center, outer, (i + 1) % 6);
+        outlines.push_back(sf::Vertex(a, sf::Color::Black));
+        outlines.push_back(sf::Vertex(outerA, sf::Color::Black));
+        outlines.push_back(sf::Vertex(outerB, sf::Color::Black));
+        outlines.push_back(sf::Vertex(a, sf::Color::Black));
+        outlines.push_back(sf::Vertex(outerB, sf::Color::Black));
+        outlines.push_back(sf::Vertex(b, sf::Color::Black));
+    }
+    values[vertices.getVertexCount() / FILL_VERTICES_PER_CELL - 1] = cell.value;
+}
+
+void BoardRenderer::endBuild() {
+    for (const auto &vertex : outlines)
+        vertices.append(vertex);
+    outlines.clear();
+    outlines.shrink_to_fit();
+}
+
+void BoardRenderer::setCellValue(int index, char value) {
+    values[index] = value;
+    writeFill(index);
+}
+
+void BoardRenderer::setHoveredCell(int index) {
+    if (index == hoveredCell)
+        return;
+    int previous = hoveredCell;
+    hoveredCell = index;
+    if (previous >= 0)
+        writeFill(previous);
+    if (index >= 0)
+        writeFill(index);
+}
+
+void BoardRenderer::writeFill(int index) {
+    sf::Color fill = fillColorFor(index, values[index]);
+    std::size_t first = static_cast<std::size_t>(index) * FILL_VERTICES_PER_CELL;
+    for (std::size_t i = first; i < first + FILL_VERTICES_PER_CELL; i++)
+        vertices[i].color = fill;
+}
+
+sf::Color BoardRenderer::fillColorFor(int index, char value) const {
+    if (value == 'X')
+        return AMU_RED;
+    if (value == 'O')
+        return AMU_GREEN;
+    if (index >= 0 && index == hoveredCell)
+        return HOVER_COLOR;
+    return AMU_WHITE;
+}
+
+void BoardRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    states.transform *= getTransform();
+    target.draw(vertices, states);
+}
+
+AnalysisOverlay::AnalysisOverlay() : vertices(sf::Triangles), k(0) {
+}
+
+void AnalysisOverlay::beginBuild(int cellCount, int winLength) {
+    vertices.clear();
+    labels.assign(cellCount, TextLabel());
+    shownScores.assign(cellCount, ANALYSIS_NO_SCORE);
+    shownExact.assign(cellCount, false);
+    k = winLength;
+}
+
+void AnalysisOverlay::addCell(const HexCell& cell) {
+    sf::Vector2f center = hexAxialToPixel(cell.q, cell.r);
+    int index = static_cast<int>(vertices.getVertexCount()) / BoardRenderer::FILL_VERTICES_PER_CELL;
+    for (int i = 0; i < 6; i++) {
+        vertices.append(sf::Vertex(center, sf::Color::Transparent));
+        vertices.append(sf::Vertex(hexCorner(center, HEAT_RADIUS, i), sf::Color::Transparent));
+        vertices.append(sf::Vertex(hexCorner(center, HEAT_RADIUS, (i + 1) % 6), sf::Color::Transparent));
+    }
+    labels[index].setCenter(center.x, center.y);
+}
+
+void AnalysisOverlay::update(const AnalysisSnapshot& snapshot) {
+    for (std::size_t i = 0; i < labels.size() && i < snapshot.scores.size(); i++)
+        setCell(static_cast<int>(i), snapshot.scores[i], snapshot.finished);
+}
+
+void AnalysisOverlay::clear() {
+    for (std::size_t i = 0; i < labels.size(); i++)
+        setCell(static_cast<int>(i), ANALYSIS_NO_SCORE, false);
+}
+
+void AnalysisOverlay::setCell(int index, int score, bool exact) {
+    if (score == shownScores[index] && exact == shownExact[index])
+        return;
+    shownScores[index] = score;
+    shownExact[index] = exact;
+    sf::Color fill = score == ANALYSIS_NO_SCORE ? sf::Color::Transparent : heatColor(analysisWinProbability(score, k));
+    std::size_t first = static_cast<std::size_t>(index) * BoardRenderer::FILL_VERTICES_PER_CELL;
+    for (std::size_t i = first; i < first + BoardRenderer::FILL_VERTICES_PER_CELL; i++)
+        vertices[i].color = fill;
+    if (score != ANALYSIS_NO_SCORE)
+        labels[index].setContent(analysisLabel(score, exact, k), FONT_STANDARD, TEXT_SIZE_SMALL, sf::Color::White);
+}
+
+void AnalysisOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    states.transform *= getTransform();
+    target.draw(vertices, states);
+    for (std::size_t i = 0; i < labels.size(); i++) {
+        if (shownScores[i] != ANALYSIS_NO_SCORE)
+            target.draw(labels[i], states);
+    }
+}
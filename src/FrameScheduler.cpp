@@ -0,0 +1,101 @@
+// FrameScheduler.cpp
+#include "FrameScheduler.h"
+
+const sf::Time FrameScheduler::POLL_INTERVAL = sf::milliseconds(4);
+const sf::Time FrameScheduler::MAX_POLL_INTERVAL = sf::milliseconds(25);
+
+FrameScheduler::FrameScheduler(FramePacing pacing, unsigned frameRateLimit)
+    : pacing(pacing),
+      frameInterval(sf::microseconds(1000000 / (frameRateLimit > 0 ? frameRateLimit : 60))),
+      hasDeadline(false),
+      redrawPending(true),
+      idleSeconds(0),
+      pollInterval(POLL_INTERVAL),
+      emptyPolls(0) {
+}
+
+void FrameScheduler::setPacing(FramePacing newPacing) {
+    pacing = newPacing;
+    redrawPending = true;
+}
+
+void FrameScheduler::scheduleAt(sf::Time time) {
+    if (!hasDeadline || time < deadline) {
+        deadline = time;
+        hasDeadline = true;
+    }
+}
+
+void FrameScheduler::requestRedrawIn(sf::Time delay) {
+    scheduleAt(clock.getElapsedTime() + delay);
+}
+
+void FrameScheduler::requestAnimationFrame() {
+    scheduleAt(lastFrame + frameInterval);
+}
+
+bool FrameScheduler::waitEvent(sf::RenderWindow& window, sf::Event& event) {
+    for (;;) {
+        if (window.pollEvent(event)) {
+            pollInterval = POLL_INTERVAL;
+            emptyPolls = 0;
+            return true;
+        }
+        sf::Time now = clock.getElapsedTime();
+        sf::Time wakeAt;
+        if (pacing == PACING_CAPPED) {
+            wakeAt = lastFrame + frameInterval;
+        } else {
+            if (redrawPending)
+                return false;
+            if (!hasDeadline) {
+                sleepFor(nextPollInterval());
+                continue;
+            }
+            wakeAt = deadline;
+        }
+        if (now >= wakeAt)
+            return false;
+        sf::Time wait = wakeAt - now;
+        sf::Time poll = nextPollInterval();
+        sleepFor(wait < poll ? wait : poll);
+    }
+}
+
+sf::Time FrameScheduler::nextPollInterval() {
+    // A few quick polls after input keep pointer movement responsive; an idle window then
+    // settles at about 40 wake-ups per second.
+    if (++emptyPolls > IDLE_POLLS_BEFORE_BACKOFF && pollInterval < MAX_POLL_INTERVAL) {
+        pollInterval = sf::microseconds(pollInterval.asMicroseconds() * 2);
+        if (pollInterval > MAX_POLL_INTERVAL)
+            pollInterval = MAX_POLL_INTERVAL;
+    }
+    return pollInterval;
+}
+
+void FrameScheduler::sleepFor(sf::Time duration) {
+    sf::Time before = clock.getElapsedTime();
+    sf::sleep(duration);
+    idleSeconds += (clock.getElapsedTime() - before).asSeconds();
+}
+
+bool FrameScheduler::frameDue() {
+    sf::Time now = clock.getElapsedTime();
+    bool due;
+    if (pacing == PACING_CAPPED)
+        due = now >= lastFrame + frameInterval;
+    else
+        due = redrawPending || (hasDeadline && now >= deadline);
+    if (due) {
+        lastFrame = now;
+        redrawPending = false;
+        hasDeadline = false;
+    }
+    return due;
+}
+
+double FrameScheduler::takeIdleSeconds() {
+    double idle = idleSeconds;
+    idleSeconds = 0;
+    return idle;
+}
@@ -0,0 +1,85 @@
+// FrameStats.cpp
+#include "FrameStats.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string formatMillis(double seconds) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f ms", seconds * 1000.0);
+    return buffer;
+}
+
+} // namespace
+
+FrameStats::FrameStats()
+    : histogram(BUCKET_COUNT + 1, 0),
+      drawnFrames(0),
+      loopIterations(0),
+      eventSeconds(0),
+      drawSeconds(0),
+      idleSeconds(0),
+      firstFrame(0),
+      startTime(nowSeconds()) {
+}
+
+void FrameStats::recordFrame(double events, double draw, bool drew) {
+    eventSeconds += events;
+    loopIterations++;
+    if (!drew)
+        return;
+    drawSeconds += draw;
+    drawnFrames++;
+    long bucket = static_cast<long>((events + draw) * 1e6 / BUCKET_MICROS);
+    histogram[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT]++;
+}
+
+double FrameStats::percentile(double p) const {
+    if (drawnFrames == 0)
+        return 0.0;
+    std::uint64_t target = static_cast<std::uint64_t>(p * (drawnFrames - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (int i = 0; i <= BUCKET_COUNT; i++) {
+        seen += histogram[i];
+        if (seen >= target)
+            return (i + 1) * BUCKET_MICROS / 1e6;  // Upper edge of the bucket
+    }
+    return BUCKET_COUNT * BUCKET_MICROS / 1e6;
+}
+
+double FrameStats::wallSeconds() const {
+    return nowSeconds() - startTime;
+}
+
+double FrameStats::busyFraction() const {
+    double wall = wallSeconds();
+    return wall > 0 ? 1.0 - idleSeconds / wall : 0.0;
+}
+
+std::string FrameStats::summary() const {
+    char buffer[160];
+    double wall = wallSeconds();
+    std::snprintf(buffer, sizeof(buffer), "p50 %s | p99 %s | draw %s | events %s | %.0f fps | busy %.1f%%",
+                  formatMillis(percentile(0.50)).c_str(), formatMillis(percentile(0.99)).c_str(),
+                  formatMillis(meanDrawSeconds()).c_str(), formatMillis(meanEventSeconds()).c_str(),
+                  wall > 0 ? drawnFrames / wall : 0.0, busyFraction() * 100.0);
+    return buffer;
+}
+
+void FrameStats::dump(std::ostream& out) const {
+    double wall = wallSeconds();
+    out << "Frame stats over " << wall << " s, " << drawnFrames << " frames in " << loopIterations << " loop iterations\n"
+        << "  first frame:    " << formatMillis(firstFrame) << " after startup\n"
+        << "  frame time p50: " << formatMillis(percentile(0.50)) << "\n"
+        << "  frame time p99: " << formatMillis(percentile(0.99)) << "\n"
+        << "  mean draw:      " << formatMillis(meanDrawSeconds()) << "\n"
+        << "  mean events:    " << formatMillis(meanEventSeconds()) << " per iteration\n"
+        << "  time drawing:   " << drawSeconds << " s\n"
+        << "  time in events: " << eventSeconds << " s\n"
+        << "  time idle:      " << idleSeconds << " s (busy " << busyFraction() * 100.0 << "%)\n";
+}
@@ -5,23 +5,37 @@
 #include <iostream>
 #include <algorithm>
 
-// Utility function: Euclidean distance between two points.
-float distance(const sf::Vector2f& a, const sf::Vector2f& b) {
-    float dx = a.x - b.x;
-    float dy = a.y - b.y;
-    return std::sqrt(dx * dx + dy * dy);
+Game::Game() : Game(sf::Vector2u(0, 0)) {
+    window.create(sf::VideoMode::getDesktopMode(), "Hex Tic Tac Toe", sf::Style::Fullscreen);
+    surfaceSize = window.getSize();
+    recalcBoardOffset();
 }
 
-Game::Game() 
-    : window(sf::VideoMode::getDesktopMode(), "Hex Tic Tac Toe", sf::Style::Fullscreen),
+Game::Game(const sf::Vector2u& size)
+    : surfaceSize(size),
       currentPlayer('X'),
       gameOver(false),
-      bgColor(sf::Color::Black) {
+      bgColor(sf::Color::Black),
+      aiEnabled(false),
+      aiPlayer('O'),
+      aiThinking(false),
+      analysisEnabled(false),
+      analysisPosition(0),
+      timerSeconds(-1),
+      showFrameStats(false),
+      remoteEnabled(false),
+      remotePlaying(false),
+      remoteMovePending(false),
+      localPlayer('X'),
+      recorder(GAME_RECORD_PATH) {
+    // Fonts and the glyphs of every text size are ready before the first frame needs them.
+    UI::loadFonts();
+
     // Compute the bounding box of the board using the axial positions.
-    auto &cells = board.getCells();
+    const auto cells = board.getCells();
     float minX = 1e9, maxX = -1e9, minY = 1e9, maxY = -1e9;
     for (const auto &cell : cells) {
-        sf::Vector2f pos = board.axialToPixel(cell.q, cell.r);
+        sf::Vector2f pos = hexAxialToPixel(cell.q, cell.r);
         minX = std::min(minX, pos.x);
         maxX = std::max(maxX, pos.x);
         minY = std::min(minY, pos.y);
@@ -30,7 +44,17 @@ Game::Game()
     boardWidth = maxX - minX + HEX_SIZE * 2;
     boardHeight = maxY - minY + HEX_SIZE * 2;
     
+    boardRenderer.build(board);
+    analysisOverlay.build(board);
     recalcBoardOffset();
+    
+    // Static text is laid out once.
+    titleLabel.setContent("Hex Tic Tac Toe", FONT_STANDARD, TEXT_SIZE_TITLE, sf::Color::Cyan);
+    signatureLabel.setContent("Fawwaz Bin Tasneem", FONT_STANDARD, TEXT_SIZE_SMALL, sf::Color::White);
+    timerPanel.setSize(sf::Vector2f(200, 50));
+    timerPanel.setFillColor(sf::Color(0, 0, 0, 150)); // semi-transparent black
+    updateTurnLabels();
+    loadTablebase();
     // Clocks (animationClock and gameClock) start automatically.
 }
 
@@ -39,13 +63,13 @@ void Game::recalcBoardOffset() {
     // Define larger margins so that UI text is well separated from the board.
     int topMargin = 200;
     int bottomMargin = 200;
-    float availableHeight = window.getSize().y - topMargin - bottomMargin;
+    float availableHeight = surfaceSize.y - topMargin - bottomMargin;
     
     // Recalculate the board bounding box in case the window size changed.
-    auto &cells = board.getCells();
+    const auto cells = board.getCells();
     float minX = 1e9, maxX = -1e9, minY = 1e9, maxY = -1e9;
     for (const auto &cell : cells) {
-        sf::Vector2f pos = board.axialToPixel(cell.q, cell.r);
+        sf::Vector2f pos = hexAxialToPixel(cell.q, cell.r);
         minX = std::min(minX, pos.x);
         maxX = std::max(maxX, pos.x);
         minY = std::min(minY, pos.y);
@@ -55,134 +79,508 @@ void Game::recalcBoardOffset() {
     boardHeight = maxY - minY + HEX_SIZE * 2;
     
     boardOffset = sf::Vector2f(
-        (window.getSize().x - boardWidth) / 2 - minX + HEX_SIZE,
+        (surfaceSize.x - boardWidth) / 2 - minX + HEX_SIZE,
         topMargin + (availableHeight - boardHeight) / 2 - minY + HEX_SIZE
     );
+    // The board geometry is in board coordinates; only its placement changes.
+    boardRenderer.setPosition(boardOffset);
+    analysisOverlay.setPosition(boardOffset);
+}
+
+int Game::cellAtScreen(int x, int y) const {
+    // Adjust the position relative to the board coordinate system, then invert the
+    // axial-to-pixel conversion; this is exact over the whole hexagon and O(1).
+    sf::Vector2f boardPos(static_cast<float>(x), static_cast<float>(y));
+    boardPos -= boardOffset;
+    return hexPixelToCell(board, boardPos);
+}
+
+bool Game::canPlayLocally() const {
+    if (gameOver || aiThinking)
+        return false;
+    return !remoteEnabled || (remotePlaying && currentPlayer == localPlayer && !remoteMovePending);
 }
 
 void Game::handleClick(int x, int y) {
+    if (!canPlayLocally())
+        return;
+    int index = cellAtScreen(x, y);
+    if (index >= 0 && board.valueAt(index) == ' ') {
+        if (remoteEnabled) {
+            // The server is authoritative; the move is played when it comes back.
+            remoteMovePending = remote.send(NetMessage{NET_MOVE, 0, static_cast<std::uint16_t>(index)});
+        } else {
+            playMove(index);
+            startAiTurn();
+        }
+    }
+    updateHover(x, y);
+}
+
+void Game::updateHover(int x, int y) {
+    // Only highlight cells the player could click right now.
+    int index = cellAtScreen(x, y);
+    if (index >= 0 && (!canPlayLocally() || board.valueAt(index) != ' '))
+        index = -1;
+    if (index != boardRenderer.getHoveredCell()) {
+        boardRenderer.setHoveredCell(index);
+        scheduler.requestRedraw();
+    }
+}
+
+void Game::playMove(int index) {
+    if (!board.makeMoveAt(index, currentPlayer))
+        return;
+    boardRenderer.setCellValue(index, currentPlayer);
+    // The highlighted cell may be taken, the game over, or the AI about to think; the next
+    // pointer movement (or handleClick) works out a new highlight.
+    boardRenderer.setHoveredCell(-1);
+    moveHistory.push_back(index);
+    HEX_TRACE_INFO(TRACE_MOVE, index, currentPlayer, board.cellAt(index).q, board.cellAt(index).r);
+    HEX_METRIC_ADD(metrics::movesPlayed, 1);
+    char winner = board.checkWinnerAt(index);
+    if (winner != ' ') {
+        gameOver = true;
+        winnerText = "Winner: Player " + std::string(1, winner);
+        updateWinnerLabel();
+    } else if (board.isFull()) {
+        gameOver = true;
+        winnerText = "Game Drawn!";
+        updateWinnerLabel();
+    } else {
+        currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
+    }
+    if (gameOver) {
+        HEX_TRACE_INFO(TRACE_GAME_OVER, winner == ' ' ? 'D' : winner, board.moveCount());
+        HEX_METRIC_ADD(metrics::gamesFinished, 1);
+        recordGame();
+    }
+    updateTurnLabels();
+    if (aiEnabled)
+        updateAiLabel();
+    updateAnalysis();
+}
+
+void Game::recordGame() {
+    if (moveHistory.empty())
+        return;
+    GameResult result = gameResultFor(board.checkWinner(), board.isFull());
+    // Flushed right away so a finished game survives the program being killed.
+    if (!recorder.append(board.radius(), board.winLength(), result, moveHistory) || !recorder.flush())
+        std::cerr << "Failed to record game to " << GAME_RECORD_PATH << std::endl;
+    moveHistory.clear();
+}
+
+void Game::loadTablebase() {
+    sf::Clock openClock;
+    std::string error;
+    if (!tablebase.open(TABLEBASE_DEFAULT_PATH, error)) {
+        if (!error.empty())
+            std::cerr << error << std::endl;
+        return;
+    }
+    if (tablebase.radius() != board.radius() || tablebase.winLength() != board.winLength()) {
+        std::cerr << TABLEBASE_DEFAULT_PATH << " is for another board size; not used" << std::endl;
+        tablebase.close();
+        return;
+    }
+    HEX_TRACE_INFO(TRACE_TABLEBASE, static_cast<std::int32_t>(std::min<std::uint64_t>(tablebase.entryCount(), INT32_MAX)),
+                   static_cast<std::int32_t>(openClock.getElapsedTime().asMicroseconds()), tablebase.complete());
+}
+
+void Game::startAiTurn() {
+    if (!aiEnabled || aiThinking || gameOver || currentPlayer != aiPlayer)
+        return;
+    // A position in the tablebase needs no search: its stored move is played right away.
+    TablebaseResult solved;
+    if (tablebase.probe(board, solved)) {
+        HEX_METRIC_ADD(metrics::tablebaseHits, 1);
+        playMove(solved.bestMove);
+        scheduler.requestRedraw();
+        return;
+    }
+    // The search runs on worker threads; the render loop keeps going and pollAi() picks
+    // up the move once the time budget has expired.
+    ai.startSearch(board, currentPlayer, AI_MOVE_SECONDS);
+    aiThinking = true;
+    updateAiLabel();
+}
+
+void Game::pollAi() {
+    if (!aiThinking)
+        return;
+    if (!ai.isFinished()) {
+        // The statistics change continuously during a search; a few refreshes a second do.
+        if (aiStatsClock.getElapsedTime() >= AI_STATS_REFRESH)
+            updateAiLabel();
+        return;
+    }
+    aiThinking = false;
+    int move = ai.bestMove();
+    if (move >= 0)
+        playMove(move);
+    updateAiLabel();
+    scheduler.requestRedraw();
+}
+
+void Game::updateAnalysis() {
+    if (!analysisEnabled)
+        return;
+    // The old scores are hidden rather than shown against the new position; the first
+    // iterations of the new one take milliseconds.
+    analysisPosition = analyzer->setPosition(board, currentPlayer);
+    analysisOverlay.clear();
+    updateAnalysisLabel();
+}
+
+void Game::pollAnalysis() {
+    if (!analysisEnabled || !analyzer->latest(analysis))
+        return;
+    if (analysis.position == analysisPosition)
+        analysisOverlay.update(analysis);
+    updateAnalysisLabel();
+    scheduler.requestRedraw();
+}
+
+void Game::updateTurnLabels() {
+    sf::Color turnColor = (currentPlayer == 'X') ? AMU_RED : AMU_GREEN;
+    turnLabel.setContent(currentPlayer == 'X' ? "Player Turn: X" : "Player Turn: O", FONT_STANDARD, TEXT_SIZE_TURN, turnColor);
+    const char* prompt;
     if (gameOver)
+        prompt = "Press R to Restart | Press B to Toggle Background";
+    else if (remoteEnabled)
+        prompt = "Click a hexagon to play | Press R for a New Opponent | Press B to Toggle Background";
+    else
+        prompt = "Click a hexagon to play | Press A to Toggle AI | Press B to Toggle Background";
+    promptLabel.setContent(prompt, FONT_STANDARD, TEXT_SIZE_PROMPT, sf::Color::Yellow);
+}
+
+void Game::updateWinnerLabel() {
+    // Determine winner color: if "Player X", use AMU_RED; if "Player O", use AMU_GREEN; else white.
+    sf::Color winColor;
+    if (winnerText.find("Player X") != std::string::npos)
+        winColor = AMU_RED;
+    else if (winnerText.find("Player O") != std::string::npos)
+        winColor = AMU_GREEN;
+    else
+        winColor = sf::Color::White;
+    winnerLabel.setContent(winnerText, FONT_CURSIVE, TEXT_SIZE_WINNER, winColor);
+}
+
+void Game::updateRemoteLabel() {
+    remoteLabel.setContent(remoteStatus, FONT_STANDARD, TEXT_SIZE_SMALL, sf::Color::White);
+}
+
+void Game::updateAiLabel() {
+    aiStatsClock.restart();
+    MctsStats stats = ai.stats();
+    std::string aiStr = std::string("AI (") + aiPlayer + (aiThinking ? "): thinking" : "): idle")
+        + " | " + std::to_string(static_cast<long>(stats.playoutsPerSecond() / 1000)) + "k playouts/s"
+        + " | " + std::to_string(stats.treeNodes) + " nodes"
+        + " | " + std::to_string(stats.arenaBytes / (1024 * 1024)) + " MB arena";
+    TablebaseResult solved;
+    if (!gameOver && tablebase.probe(board, solved))
+        aiStr += " | tablebase: " + describeTablebaseResult(solved, currentPlayer);
+    aiLabel.setContent(aiStr, FONT_STANDARD, TEXT_SIZE_SMALL, sf::Color::White);
+}
+
+void Game::updateAnalysisLabel() {
+    std::string analysisStr = "Analysis: ";
+    if (analysis.position != analysisPosition) {
+        analysisStr += "starting";
+    } else {
+        analysisStr += "depth " + std::to_string(analysis.depth) + (analysis.finished ? " (solved)" : "")
+            + " | " + std::to_string(static_cast<long>(analysis.nodesPerSecond() / 1000)) + "k nodes/s"
+            + " | " + std::to_string(analysis.nodes) + " nodes";
+    }
+    analysisLabel.setContent(analysisStr, FONT_STANDARD, TEXT_SIZE_SMALL, sf::Color::White);
+}
+
+bool Game::connectRemote(const std::string& host, std::uint16_t port) {
+    std::string error;
+    if (!remote.connect(host, port, error)) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    remoteEnabled = true;
+    aiEnabled = false;
+    updateTurnLabels();
+    remoteStatus = "Online: waiting for an opponent";
+    updateRemoteLabel();
+    remote.send(NetMessage{NET_JOIN, WIN_LENGTH, BOARD_RADIUS});
+    return true;
+}
+
+void Game::pollRemote() {
+    if (!remoteEnabled)
         return;
-    sf::Vector2f clickPos(x, y);
-    // Adjust click position relative to board coordinate system.
-    clickPos -= boardOffset;
-    
-    // Iterate through all cells to see if the click is near a cell’s center.
-    for (const auto &cell : board.getCells()) {
-        sf::Vector2f cellPos = board.axialToPixel(cell.q, cell.r);
-        if (distance(clickPos, cellPos) < HEX_SIZE * 0.8f) {  // threshold for click detection
-            if (board.makeMove(cell.q, cell.r, currentPlayer)) {
-                std::cout << "Debug: Move - Player " << currentPlayer 
-                          << " moved to cell (" << cell.q << "," << cell.r << ")\n";
-                char winner = board.checkWinner();
-                if (winner != ' ') {
-                    gameOver = true;
-                    winnerText = "Winner: Player " + std::string(1, winner);
-                } else if (board.isFull()) {
-                    gameOver = true;
-                    winnerText = "Game Drawn!";
-                } else {
-                    currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
-                }
-            }
-            return; // Process only one cell per click.
+    NetMessage message;
+    while (remote.receive(message)) {
+        if (message.type == NET_START) {
+            recordGame();
+            resetBoard();
+            localPlayer = static_cast<char>(message.arg);
+            remotePlaying = true;
+            remoteStatus = std::string("Online: you are ") + localPlayer;
+            updateRemoteLabel();
+        } else if (message.type == NET_MOVED) {
+            if (message.value < board.cellCount())
+                playMove(message.value);
+            remoteMovePending = false;
+            if (message.arg != RESULT_UNFINISHED)
+                remotePlaying = false;
+        } else if (message.type == NET_END) {
+            remotePlaying = false;
+            gameOver = true;
+            winnerText = "Opponent left";
+            remoteStatus = "Online: opponent left (R for a new game)";
+            updateWinnerLabel();
+            updateRemoteLabel();
+            updateTurnLabels();
+            recordGame();
+        } else if (message.type == NET_ERROR) {
+            remoteMovePending = false;
+            std::cerr << "Server rejected a request (error " << static_cast<int>(message.arg) << ")" << std::endl;
         }
+        scheduler.requestRedraw();
     }
+    if (!remote.connected() && remoteStatus != "Online: disconnected") {
+        remotePlaying = false;
+        remoteMovePending = false;
+        remoteStatus = "Online: disconnected";
+        updateRemoteLabel();
+        scheduler.requestRedraw();
+    }
+}
+
+void Game::resetBoard() {
+    ai.stop();
+    aiThinking = false;
+    board = GameBoard();
+    boardRenderer.sync(board);
+    boardRenderer.setHoveredCell(-1);
+    currentPlayer = 'X';
+    gameOver = false;
+    winnerText = "";
+    animationClock.restart();
+    gameClock.restart();
+    updateTurnLabels();
+    if (aiEnabled)
+        updateAiLabel();
+    updateAnalysis();
 }
 
 void Game::draw() {
-    window.clear(bgColor);
+    drawFrame(window);
+    window.display();
+}
+
+void Game::drawFrame(sf::RenderTarget& target) {
+    target.clear(bgColor);
     
-    board.draw(window, boardOffset);
+    target.draw(boardRenderer);
+    if (analysisEnabled && !gameOver)
+        target.draw(analysisOverlay);
     
-    // Draw a title at the very top.
-    UI::drawText(window, "Hex Tic Tac Toe", window.getSize().x / 2, 30, 42, sf::Color::Cyan);
+    float width = static_cast<float>(target.getSize().x);
+    float height = static_cast<float>(target.getSize().y);
     
-    // Draw current turn text near the top (outside the board area).
-    sf::Color turnColor = (currentPlayer == 'X') ? AMU_RED : AMU_GREEN;
-    UI::drawText(window, "Player Turn: " + std::string(1, currentPlayer),
-                 window.getSize().x / 2, 80, 36, turnColor);
+    // Label text is set when the state it shows changes; positioning and the winner
+    // animation below are transform updates.
     
-    // Draw timer panel in the top-right.
-    float elapsed = gameClock.getElapsedTime().asSeconds();
-    int secondsElapsed = static_cast<int>(elapsed);
-    std::string timerStr = "Time: " + std::to_string(secondsElapsed) + " sec";
+    // Draw a title at the very top.
+    titleLabel.setCenter(width / 2, 30);
+    target.draw(titleLabel);
     
-    // Draw a semi-transparent panel behind the timer text.
-    sf::RectangleShape timerPanel;
-    timerPanel.setSize(sf::Vector2f(200, 50));
-    timerPanel.setFillColor(sf::Color(0, 0, 0, 150)); // semi-transparent black
-    timerPanel.setPosition(window.getSize().x - 220, 10);
-    window.draw(timerPanel);
+    // Draw current turn text near the top (outside the board area).
+    turnLabel.setCenter(width / 2, 80);
+    target.draw(turnLabel);
     
-    UI::drawText(window, timerStr, window.getSize().x - 120, 35, 28, sf::Color::White);
+    // Draw timer panel in the top-right; the string is rebuilt once per second.
+    int secondsElapsed = static_cast<int>(gameClock.getElapsedTime().asSeconds());
+    if (secondsElapsed != timerSeconds) {
+        timerSeconds = secondsElapsed;
+        timerLabel.setContent("Time: " + std::to_string(secondsElapsed) + " sec", FONT_STANDARD, TEXT_SIZE_PROMPT, sf::Color::White);
+    }
+    timerPanel.setPosition(width - 220, 10);
+    target.draw(timerPanel);
+    timerLabel.setCenter(width - 120, 35);
+    target.draw(timerLabel);
     
     // Draw restart and background toggle prompts.
     if (gameOver) {
         float elapsedAnim = animationClock.getElapsedTime().asSeconds();
         float scale = 1.0f + 0.2f * std::sin(2 * 3.1415f * elapsedAnim); // Pulsate effect
-        
-        // Determine winner color: if "Player X", use AMU_RED; if "Player O", use AMU_GREEN; else white.
-        sf::Color winColor;
-        if (winnerText.find("Player X") != std::string::npos)
-            winColor = AMU_RED;
-        else if (winnerText.find("Player O") != std::string::npos)
-            winColor = AMU_GREEN;
-        else
-            winColor = sf::Color::White;
-            
-        UI::drawWinnerText(window, winnerText,
-                           window.getSize().x / 2, window.getSize().y - 60, 48, winColor, scale);
-        
-        UI::drawText(window, "Press R to Restart | Press B to Toggle Background", window.getSize().x / 2, window.getSize().y - 20, 28, sf::Color::Yellow);
-    } else {
-        UI::drawText(window, "Click a hexagon to play | Press B to Toggle Background", window.getSize().x / 2, window.getSize().y - 30, 28, sf::Color::Yellow);
+        winnerLabel.setCenter(width / 2, height - 60);
+        winnerLabel.setScale(scale);
+        target.draw(winnerLabel);
     }
+    promptLabel.setCenter(width / 2, gameOver ? height - 20 : height - 30);
+    target.draw(promptLabel);
     
-    // Draw your signature at the bottom-right in small text.
-    UI::drawText(window, "Fawwaz Bin Tasneem", window.getSize().x - 80, window.getSize().y - 25, 18, sf::Color::White);
+    // Draw the computer opponent's search statistics at the top-left (refreshed by pollAi()
+    // every AI_STATS_REFRESH while it thinks).
+    if (aiEnabled) {
+        aiLabel.setCenter(260, 35);
+        target.draw(aiLabel);
+    }
     
-    window.display();
+    // Draw the analysis depth and speed below it. The label is set when a snapshot arrives
+    // (at most every PUBLISH_INTERVAL_MS) or the position changes.
+    if (analysisEnabled && !gameOver) {
+        analysisLabel.setCenter(260, 60);
+        target.draw(analysisLabel);
+    }
+    
+    // Draw the online status in the same corner (the computer opponent is off online).
+    if (remoteEnabled) {
+        remoteLabel.setCenter(260, 35);
+        target.draw(remoteLabel);
+    }
+    
+    // Draw the frame-time overlay at the bottom-left.
+    if (showFrameStats) {
+        if (frameStatsClock.getElapsedTime() >= FRAME_STATS_REFRESH || frameStatsLabel.getString().empty()) {
+            frameStatsClock.restart();
+            frameStatsLabel.setContent(frameStats.summary(), FONT_STANDARD, TEXT_SIZE_SMALL, sf::Color::White);
+        }
+        frameStatsLabel.setCenter(300, height - 80);
+        target.draw(frameStatsLabel);
+    }
+    
+    // Draw your signature at the bottom-right in small text.
+    signatureLabel.setCenter(width - 80, height - 25);
+    target.draw(signatureLabel);
+}
+
+void Game::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::Closed)
+        window.close();
+    else if (event.type == sf::Event::KeyPressed) {
+        // Reset game if R is pressed.
+        if (event.key.code == sf::Keyboard::R) {
+            HEX_TRACE_INFO(TRACE_RESET, gameOver ? 0 : board.moveCount());
+            recordGame();  // An abandoned game is kept as unfinished
+            resetBoard();
+            if (remoteEnabled && remote.connected()) {
+                // Leaves (forfeits) the current online game and waits for a new opponent.
+                remotePlaying = false;
+                remoteMovePending = false;
+                remoteStatus = "Online: waiting for an opponent";
+                updateRemoteLabel();
+                remote.send(NetMessage{NET_JOIN, WIN_LENGTH, BOARD_RADIUS});
+            }
+        }
+        // Toggle background color if B is pressed.
+        else if (event.key.code == sf::Keyboard::B) {
+            bgColor = (bgColor == sf::Color::Black) ? sf::Color::White : sf::Color::Black;
+            HEX_TRACE_INFO(TRACE_BACKGROUND, bgColor == sf::Color::White);
+        }
+        // Toggle the computer opponent if A is pressed (not while playing online).
+        else if (event.key.code == sf::Keyboard::A && !remoteEnabled) {
+            aiEnabled = !aiEnabled;
+            if (!aiEnabled) {
+                ai.stop();
+                aiThinking = false;
+            } else {
+                updateAiLabel();
+            }
+            HEX_TRACE_INFO(TRACE_AI, aiEnabled);
+            startAiTurn();
+        }
+        // Toggle the analysis overlay if E is pressed (not while playing online).
+        else if (event.key.code == sf::Keyboard::E && !remoteEnabled) {
+            analysisEnabled = !analysisEnabled;
+            if (!analyzer)
+                analyzer.reset(new PositionAnalyzer(board));
+            if (analysisEnabled)
+                updateAnalysis();
+            else
+                analyzer->pause();
+            HEX_TRACE_INFO(TRACE_ANALYSIS, analysisEnabled);
+        }
+        // Switch between event-driven and capped frame pacing if P is pressed.
+        else if (event.key.code == sf::Keyboard::P) {
+            bool capped = scheduler.getPacing() == PACING_EVENT_DRIVEN;
+            scheduler.setPacing(capped ? PACING_CAPPED : PACING_EVENT_DRIVEN);
+            HEX_TRACE_INFO(TRACE_PACING, capped);
+        }
+        // Toggle the frame-time overlay if F3 is pressed.
+        else if (event.key.code == sf::Keyboard::F3) {
+            showFrameStats = !showFrameStats;
+        }
+    }
+    else if (event.type == sf::Event::Resized) {
+        // Update the view to the new size.
+        sf::FloatRect visibleArea(0, 0, event.size.width, event.size.height);
+        window.setView(sf::View(visibleArea));
+        surfaceSize = sf::Vector2u(event.size.width, event.size.height);
+        recalcBoardOffset();
+    }
+    else if (event.type == sf::Event::MouseButtonPressed) {
+        handleClick(event.mouseButton.x, event.mouseButton.y);
+    }
+    else if (event.type == sf::Event::MouseMoved) {
+        updateHover(event.mouseMove.x, event.mouseMove.y);
+        return; // updateHover() requests a redraw only if the highlight moved.
+    }
+    scheduler.requestRedraw();
+}
+
+void Game::recordFirstFrame() {
+    double seconds = startupClock.getElapsedTime().asSeconds();
+    frameStats.recordFirstFrame(seconds);
+    const FontLoadStats& fonts = UI::fontLoadStats();
+    HEX_METRIC_SET(metrics::firstFrameMillis, seconds * 1e3);
+    HEX_TRACE_INFO(TRACE_STARTUP, static_cast<std::int32_t>(seconds * 1e6),
+                   static_cast<std::int32_t>(fonts.loadSeconds * 1e6),
+                   static_cast<std::int32_t>(fonts.warmSeconds * 1e6), fonts.glyphs);
 }
 
 void Game::run() {
     while (window.isOpen()) {
+        // Schedule the next wake-up: the timer's next tick, plus continuous frames while the
+        // winner text animates or the computer is thinking.
+        float elapsed = gameClock.getElapsedTime().asSeconds();
+        scheduler.requestRedrawIn(sf::seconds(1.0f - (elapsed - std::floor(elapsed))) + sf::milliseconds(1));
+        if (gameOver || aiThinking)
+            scheduler.requestAnimationFrame();
+        // The server connection is polled on every wake-up; wake up often while a message is
+        // expected (a new game, or the opponent's move).
+        if (remoteEnabled && remote.connected() && !canPlayLocally())
+            scheduler.requestRedrawIn(REMOTE_POLL_INTERVAL);
+        if (showFrameStats)
+            scheduler.requestRedrawIn(FRAME_STATS_REFRESH);
+        // Snapshots are polled on every wake-up; wake up often while the analyzer is working.
+        if (analysisEnabled && (analysis.position != analysisPosition || !analysis.finished))
+            scheduler.requestRedrawIn(ANALYSIS_POLL_INTERVAL);
+        
         sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-            else if (event.type == sf::Event::KeyPressed) {
-                // Reset game if R is pressed.
-                if (event.key.code == sf::Keyboard::R) {
-                    board = HexBoard();
-                    currentPlayer = 'X';
-                    gameOver = false;
-                    winnerText = "";
-                    animationClock.restart();
-                    gameClock.restart();
-                    std::cout << "Debug: Game reset." << std::endl;
-                }
-                // Toggle background color if B is pressed.
-                else if (event.key.code == sf::Keyboard::B) {
-                    if (bgColor == sf::Color::Black) {
-                        bgColor = sf::Color::White;
-                        std::cout << "Debug: Background changed to White." << std::endl;
-                    } else {
-                        bgColor = sf::Color::Black;
-                        std::cout << "Debug: Background changed to Black." << std::endl;
-                    }
-                }
-            }
-            else if (event.type == sf::Event::Resized) {
-                // Update the view to the new size.
-                sf::FloatRect visibleArea(0, 0, event.size.width, event.size.height);
-                window.setView(sf::View(visibleArea));
-                recalcBoardOffset();
-            }
-            else if (event.type == sf::Event::MouseButtonPressed) {
-                handleClick(event.mouseButton.x, event.mouseButton.y);
-            }
+        bool hasEvent = scheduler.waitEvent(window, event);
+        frameStats.recordIdle(scheduler.takeIdleSeconds());
+        
+        sf::Clock workClock;
+        while (hasEvent) {
+            handleEvent(event);
+            hasEvent = window.pollEvent(event);
         }
-        draw();
+        pollAi();
+        pollRemote();
+        pollAnalysis();
+        double eventSeconds = workClock.restart().asSeconds();
+        
+        bool drew = window.isOpen() && scheduler.frameDue();
+        if (drew)
+            draw();
+        double drawSeconds = workClock.getElapsedTime().asSeconds();
+        frameStats.recordFrame(eventSeconds, drawSeconds, drew);
+        HEX_TRACE_DEBUG(TRACE_FRAME, static_cast<std::int32_t>(eventSeconds * 1e6),
+                        static_cast<std::int32_t>(drawSeconds * 1e6), drew);
+        if (drew)
+            HEX_METRIC_SET(metrics::frameDrawMicros, drawSeconds * 1e6);
+        if (drew && frameStats.frames() == 1)
+            recordFirstFrame();
     }
+    recordGame();
+    frameStats.dump(std::cout);
 }
@@ -0,0 +1,231 @@
+// GameRecord.cpp
+#include "GameRecord.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char ARCHIVE_MAGIC[4] = {'H', 'X', 'G', 'R'};
+
+std::uint32_t readU32(const std::uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+void putU32(std::uint8_t* p, std::uint32_t value) {
+    for (int i = 0; i < 4; i++)
+        p[i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+void fillArchiveHeader(std::uint8_t* header) {
+    std::memset(header, 0, GAME_ARCHIVE_HEADER_BYTES);
+    std::memcpy(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    header[4] = GAME_ARCHIVE_VERSION;
+}
+
+// Size of the readable part of the archive in 'file', hopping over the block headers as
+// GameArchive::open() does: the archive header plus every complete block. 0 if the file is
+// empty or holds only the start of an archive header (a writer killed before finishing it).
+// Returns false if the file is something else, which must not be appended to or cut.
+bool readableArchiveBytes(std::FILE* file, long& end) {
+    if (std::fseek(file, 0, SEEK_END) != 0)
+        return false;
+    long size = std::ftell(file);
+    if (size < 0 || std::fseek(file, 0, SEEK_SET) != 0)
+        return false;
+    std::uint8_t expected[GAME_ARCHIVE_HEADER_BYTES];
+    fillArchiveHeader(expected);
+    std::uint8_t header[GAME_ARCHIVE_HEADER_BYTES];
+    std::size_t got = std::fread(header, 1, sizeof(header), file);
+    if (got < sizeof(header)) {
+        end = 0;
+        return got == static_cast<std::size_t>(size) && std::memcmp(header, expected, got) == 0;
+    }
+    if (std::memcmp(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header[4] != GAME_ARCHIVE_VERSION)
+        return false;
+    end = static_cast<long>(GAME_ARCHIVE_HEADER_BYTES);
+    for (;;) {
+        std::uint8_t blockHeader[GAME_BLOCK_HEADER_BYTES];
+        if (size - end < static_cast<long>(GAME_BLOCK_HEADER_BYTES) || std::fseek(file, end, SEEK_SET) != 0 ||
+            std::fread(blockHeader, 1, sizeof(blockHeader), file) != sizeof(blockHeader))
+            return true;
+        long blockEnd = end + static_cast<long>(GAME_BLOCK_HEADER_BYTES) + static_cast<long>(readU32(blockHeader));
+        if (blockEnd > size)
+            return true;
+        end = blockEnd;
+    }
+}
+
+} // namespace
+
+bool readGameRecord(const std::uint8_t*& data, const std::uint8_t* end, GameRecordView& record) {
+    if (end - data < static_cast<std::ptrdiff_t>(GAME_RECORD_HEADER_BYTES))
+        return false;
+    record.radius = data[0];
+    record.winLength = data[1];
+    record.result = static_cast<GameResult>(data[2]);
+    record.moveCount = data[3] | (data[4] << 8);
+    record.moves = data + GAME_RECORD_HEADER_BYTES;
+    if (record.radius > MAX_BOARD_RADIUS || record.result >= GAME_RESULT_COUNT)
+        return false;
+    std::size_t moveBytes = static_cast<std::size_t>(record.moveCount) * gameMoveBytes(record.radius);
+    if (static_cast<std::size_t>(end - record.moves) < moveBytes)
+        return false;
+    data = record.moves + moveBytes;
+    return true;
+}
+
+GameRecordWriter::GameRecordWriter(const std::string& archivePath)
+    : path(archivePath), file(nullptr), blockRecords(0), failed(false) {
+    block.reserve(GAME_BLOCK_BYTES);
+}
+
+GameRecordWriter::~GameRecordWriter() {
+    flush();
+    if (file)
+        std::fclose(file);
+}
+
+bool GameRecordWriter::append(int radius, int winLength, GameResult result, const std::vector<int>& moves) {
+    if (radius < 0 || radius > MAX_BOARD_RADIUS || winLength < 1 || winLength > 255 || moves.size() > 0xFFFF)
+        return false;
+    int moveBytes = gameMoveBytes(radius);
+    std::size_t recordBytes = GAME_RECORD_HEADER_BYTES + moves.size() * moveBytes;
+    if (!block.empty() && block.size() + recordBytes > GAME_BLOCK_BYTES && !writeBlock())
+        return false;
+
+    block.push_back(static_cast<std::uint8_t>(radius));
+    block.push_back(static_cast<std::uint8_t>(winLength));
+    block.push_back(static_cast<std::uint8_t>(result));
+    block.push_back(static_cast<std::uint8_t>(moves.size()));
+    block.push_back(static_cast<std::uint8_t>(moves.size() >> 8));
+    for (int move : moves) {
+        block.push_back(static_cast<std::uint8_t>(move));
+        if (moveBytes == 2)
+            block.push_back(static_cast<std::uint8_t>(move >> 8));
+    }
+    blockRecords++;
+    return true;
+}
+
+bool GameRecordWriter::flush() {
+    if (!block.empty() && !writeBlock())
+        return false;
+    return !file || std::fflush(file) == 0;
+}
+
+bool GameRecordWriter::open() {
+    if (file)
+        return true;
+    if (failed)
+        return false;
+    file = std::fopen(path.c_str(), "r+b");
+    if (!file)
+        file = std::fopen(path.c_str(), "w+b");
+    if (!file) {
+        failed = true;
+        return false;
+    }
+    // A run killed mid-write leaves a partial block (or archive header) at the end; blocks
+    // appended after it would be unreadable, so it is cut off first.
+    long end = 0;
+    if (!readableArchiveBytes(file, end) || ::ftruncate(fileno(file), end) != 0 || std::fseek(file, end, SEEK_SET) != 0) {
+        std::fclose(file);
+        file = nullptr;
+        failed = true;
+        return false;
+    }
+    if (end == 0) {
+        std::uint8_t header[GAME_ARCHIVE_HEADER_BYTES];
+        fillArchiveHeader(header);
+        if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header))
+            failed = true;
+    }
+    return !failed;
+}
+
+bool GameRecordWriter::writeBlock() {
+    if (!open())
+        return false;
+    std::uint8_t header[GAME_BLOCK_HEADER_BYTES];
+    putU32(header, static_cast<std::uint32_t>(block.size()));
+    putU32(header + 4, blockRecords);
+    if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header) ||
+        std::fwrite(block.data(), 1, block.size(), file) != block.size()) {
+        failed = true;
+        return false;
+    }
+    block.clear();
+    blockRecords = 0;
+    return true;
+}
+
+GameArchive::GameArchive() : data(nullptr), size(0), truncatedTail(false) {
+}
+
+GameArchive::~GameArchive() {
+    close();
+}
+
+bool GameArchive::open(const std::string& path, std::string& error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < GAME_ARCHIVE_HEADER_BYTES) {
+        ::close(fd);
+        error = path + " is not a game archive";
+        return false;
+    }
+    std::size_t length = static_cast<std::size_t>(info.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    // Blocks are handed out to threads in roughly file order.
+    madvise(mapping, length, MADV_SEQUENTIAL);
+    data = static_cast<const std::uint8_t*>(mapping);
+    size = length;
+
+    if (std::memcmp(data, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || data[4] != GAME_ARCHIVE_VERSION) {
+        close();
+        error = path + " is not a game archive (or has an unsupported version)";
+        return false;
+    }
+
+    // Index the blocks; only their headers are touched here.
+    std::size_t offset = GAME_ARCHIVE_HEADER_BYTES;
+    while (offset < size) {
+        if (size - offset < GAME_BLOCK_HEADER_BYTES) {
+            truncatedTail = true;
+            break;
+        }
+        GameBlock blockInfo;
+        blockInfo.bytes = readU32(data + offset);
+        blockInfo.records = readU32(data + offset + 4);
+        blockInfo.data = data + offset + GAME_BLOCK_HEADER_BYTES;
+        if (size - offset - GAME_BLOCK_HEADER_BYTES < blockInfo.bytes) {
+            truncatedTail = true;
+            break;
+        }
+        blockList.push_back(blockInfo);
+        offset += GAME_BLOCK_HEADER_BYTES + blockInfo.bytes;
+    }
+    return true;
+}
+
+void GameArchive::close() {
+    if (data)
+        munmap(const_cast<std::uint8_t*>(data), size);
+    data = nullptr;
+    size = 0;
+    blockList.clear();
+    truncatedTail = false;
+}
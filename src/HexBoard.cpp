@@ -1,112 +1,106 @@
 // HexBoard.cpp
 #include "HexBoard.h"
-#include <cmath>
 #include <algorithm>
-#include <iostream>
-#include <cstring>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
 
-HexBoard::HexBoard() {
-    // Generate all valid cells for a hex board with radius BOARD_RADIUS.
-    // Valid axial coordinates satisfy: |q| <= BOARD_RADIUS, |r| <= BOARD_RADIUS, and |q + r| <= BOARD_RADIUS.
-    for (int q = -BOARD_RADIUS; q <= BOARD_RADIUS; q++) {
-        int r1 = std::max(-BOARD_RADIUS, -q - BOARD_RADIUS);
-        int r2 = std::min(BOARD_RADIUS, -q + BOARD_RADIUS);
-        for (int r = r1; r <= r2; r++) {
-            HexCell cell;
-            cell.q = q;
-            cell.r = r;
-            cell.value = ' ';
-            cells.push_back(cell);
-        }
-    }
+HexGeometry::HexGeometry(int radius, int k)
+    : boardRadius(radius), lineLength(k), span(2 * radius + 1) {
+    if (radius < 0 || radius > MAX_BOARD_RADIUS || k < 1)
+        throw std::invalid_argument("unsupported board size");
+    index.resize(span * span);
+    coords.resize(hexCellCount(radius));
+    neighbors.resize(hexCellCount(radius));
+    lines.resize(hexLineCount(radius, k));
+    fillHexTables(*this, radius, k);
 }
 
-bool HexBoard::makeMove(int q, int r, char player) {
-    // Find the cell with axial coordinates (q, r)
-    for (auto &cell : cells) {
-        if (cell.q == q && cell.r == r) {
-            if (cell.value == ' ') {
-                cell.value = player;
-                return true;
-            }
-            return false;
-        }
-    }
-    return false;
+std::shared_ptr<const HexGeometry> HexGeometry::get(int radius, int k) {
+    // Tables for a given size are built once and shared by every board of that size.
+    static std::mutex cacheMutex;
+    static std::map<std::pair<int, int>, std::shared_ptr<const HexGeometry>> cache;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto &entry = cache[std::make_pair(radius, k)];
+    if (!entry)
+        entry = std::make_shared<const HexGeometry>(radius, k);
+    return entry;
 }
 
-char HexBoard::checkWinner() {
-    // Axial neighbor directions for flat-topped hexagons.
-    // Standard offsets: { (1,0), (0,1), (-1,1), (-1,0), (0,-1), (1,-1) }
-    int directions[6][2] = {
-        {1, 0}, {0, 1}, {-1, 1},
-        {-1, 0}, {0, -1}, {1, -1}
-    };
-    // For each cell that is not empty, check in all 6 directions for 2 consecutive matching neighbors.
-    for (const auto &cell : cells) {
-        if (cell.value == ' ') continue;
-        for (int d = 0; d < 6; d++) {
-            int dq = directions[d][0];
-            int dr = directions[d][1];
-            int q1 = cell.q + dq, r1 = cell.r + dr;
-            int q2 = cell.q + 2 * dq, r2 = cell.r + 2 * dr;
-            char v1 = ' ', v2 = ' ';
-            bool found1 = false, found2 = false;
-            for (const auto &c : cells) {
-                if (c.q == q1 && c.r == r1) { v1 = c.value; found1 = true; }
-                if (c.q == q2 && c.r == r2) { v2 = c.value; found2 = true; }
-            }
-            if (found1 && found2 && v1 == cell.value && v2 == cell.value) {
-                std::cout << "Debug: Winning condition found: Cell (" << cell.q << "," << cell.r 
-                          << ") with value " << cell.value << " has consecutive neighbors at ("
-                          << q1 << "," << r1 << ") and (" << q2 << "," << r2 
-                          << ") in direction (" << dq << "," << dr << ")\n";
-                return cell.value;
-            }
-        }
-    }
-    return ' ';
+DynamicHexBoard::DynamicHexBoard(int radius, int k)
+    : geometry(HexGeometry::get(radius, k)),
+      xStones(geometry->cellCount()),
+      oStones(geometry->cellCount()),
+      occupied(0) {
 }
 
-bool HexBoard::isFull() {
-    for (const auto &cell : cells) {
-        if (cell.value == ' ')
-            return false;
-    }
+bool DynamicHexBoard::makeMoveAt(int index, char player) {
+    if (index < 0 || xStones[index] || oStones[index])
+        return false;
+    if (player == 'X')
+        xStones.set(index);
+    else
+        oStones.set(index);
+    occupied++;
     return true;
 }
 
-std::vector<HexCell>& HexBoard::getCells() {
-    return cells;
+char DynamicHexBoard::checkWinner() const {
+    if (hexrules::hasLine(*geometry, xStones, geometry->winLength()))
+        return 'X';
+    if (hexrules::hasLine(*geometry, oStones, geometry->winLength()))
+        return 'O';
+    return ' ';
+}
+
+char DynamicHexBoard::checkWinnerAt(int index) const {
+    if (index < 0)
+        return ' ';
+    if (xStones[index])
+        return hexrules::completesLine(*geometry, xStones, index, geometry->winLength()) ? 'X' : ' ';
+    if (oStones[index])
+        return hexrules::completesLine(*geometry, oStones, index, geometry->winLength()) ? 'O' : ' ';
+    return ' ';
 }
 
-sf::Vector2f HexBoard::axialToPixel(int q, int r) {
+HexCell DynamicHexBoard::cellAt(int index) const {
+    HexCell cell;
+    cell.q = geometry->coords[index][0];
+    cell.r = geometry->coords[index][1];
+    cell.value = valueAt(index);
+    return cell;
+}
+
+void hexAxialToPoint(int q, int r, float size, float& x, float& y) {
     // Conversion formula for flat-topped hexagons:
-    // x = HEX_SIZE * 3/2 * q
-    // y = HEX_SIZE * sqrt(3) * (r + q/2)
-    float x = HEX_SIZE * 1.5f * q;
-    float y = HEX_SIZE * std::sqrt(3) * (r + q / 2.0f);
-    return sf::Vector2f(x, y);
+    // x = size * 3/2 * q
+    // y = size * sqrt(3) * (r + q/2)
+    x = size * 1.5f * q;
+    y = static_cast<float>(size * std::sqrt(3) * (r + q / 2.0f));
 }
 
-void HexBoard::draw(sf::RenderWindow& window, const sf::Vector2f& offset) {
-    for (const auto &cell : cells) {
-        sf::Vector2f pos = axialToPixel(cell.q, cell.r) + offset;
-        sf::CircleShape hex(HEX_SIZE, 6);
-        // Rotate 30° to get flat-topped hexagons.
-        hex.setRotation(30);
-        sf::Color fillColor;
-        if (cell.value == 'X')
-            fillColor = AMU_RED;
-        else if (cell.value == 'O')
-            fillColor = AMU_GREEN;
-        else
-            fillColor = AMU_WHITE;
-        hex.setFillColor(fillColor);
-        hex.setOutlineColor(sf::Color::Black);
-        hex.setOutlineThickness(2);
-        hex.setPosition(pos);
-        hex.setOrigin(HEX_SIZE, HEX_SIZE);
-        window.draw(hex);
-    }
+void hexPointToAxial(float x, float y, float size, int& q, int& r) {
+    // Invert the conversion above to get fractional axial coordinates:
+    // q = x / (size * 3/2)
+    // r = y / (size * sqrt(3)) - q/2
+    float fq = x / (size * 1.5f);
+    float fr = y / (size * std::sqrt(3.0f)) - fq / 2.0f;
+    float fs = -fq - fr;
+
+    // Cube rounding: round all three cube coordinates, then recompute the one that moved
+    // the most so that q + r + s == 0 still holds.
+    float rq = std::round(fq);
+    float rr = std::round(fr);
+    float rs = std::round(fs);
+    float dq = std::fabs(rq - fq);
+    float dr = std::fabs(rr - fr);
+    float ds = std::fabs(rs - fs);
+    if (dq > dr && dq > ds)
+        rq = -rr - rs;
+    else if (dr > ds)
+        rr = -rq - rs;
+    q = static_cast<int>(rq);
+    r = static_cast<int>(rr);
 }
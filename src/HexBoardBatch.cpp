@@ -0,0 +1,188 @@
+// HexBoardBatch.cpp
+#include "HexBoardBatch.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HEX_BATCH_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Everything a kernel needs; planes and results are laid out group after group.
+struct BatchJob {
+    const HexBatchLanes* x;
+    const HexBatchLanes* o;
+    std::size_t groups;
+    int cells;
+    const std::int16_t* lineCells;
+    std::size_t lines;
+    int k;
+    std::uint64_t* xWins;   // 4 words per group
+    std::uint64_t* oWins;
+    std::uint64_t* full;
+};
+
+// K > 0 fixes the line length at compile time so the AND chain is unrolled; K == 0 reads
+// it from the job.
+template <int K>
+void evaluateScalar(const BatchJob& job) {
+    const int k = K > 0 ? K : job.k;
+    for (std::size_t group = 0; group < job.groups; group++) {
+        const HexBatchLanes* x = job.x + group * job.cells;
+        const HexBatchLanes* o = job.o + group * job.cells;
+        for (int w = 0; w < 4; w++) {
+            std::uint64_t filled = ~std::uint64_t(0);
+            for (int cell = 0; cell < job.cells; cell++)
+                filled &= x[cell].words[w] | o[cell].words[w];
+            std::uint64_t xWin = 0, oWin = 0;
+            const std::int16_t* line = job.lineCells;
+            for (std::size_t i = 0; i < job.lines; i++, line += k) {
+                std::uint64_t xLine = x[line[0]].words[w];
+                std::uint64_t oLine = o[line[0]].words[w];
+                for (int j = 1; j < k; j++) {
+                    xLine &= x[line[j]].words[w];
+                    oLine &= o[line[j]].words[w];
+                }
+                xWin |= xLine;
+                oWin |= oLine;
+            }
+            job.xWins[group * 4 + w] = xWin;
+            job.oWins[group * 4 + w] = oWin;
+            job.full[group * 4 + w] = filled;
+        }
+    }
+}
+
+#ifdef HEX_BATCH_HAVE_AVX2
+// Same as evaluateScalar, 256 boards per instruction. Only called after a CPU check.
+template <int K>
+__attribute__((target("avx2"))) void evaluateAvx2(const BatchJob& job) {
+    const int k = K > 0 ? K : job.k;
+    for (std::size_t group = 0; group < job.groups; group++) {
+        const __m256i* x = reinterpret_cast<const __m256i*>(job.x + group * job.cells);
+        const __m256i* o = reinterpret_cast<const __m256i*>(job.o + group * job.cells);
+        __m256i filled = _mm256_set1_epi64x(-1);
+        for (int cell = 0; cell < job.cells; cell++)
+            filled = _mm256_and_si256(filled, _mm256_or_si256(_mm256_load_si256(x + cell), _mm256_load_si256(o + cell)));
+        __m256i xWin = _mm256_setzero_si256();
+        __m256i oWin = _mm256_setzero_si256();
+        const std::int16_t* line = job.lineCells;
+        for (std::size_t i = 0; i < job.lines; i++, line += k) {
+            __m256i xLine = _mm256_load_si256(x + line[0]);
+            __m256i oLine = _mm256_load_si256(o + line[0]);
+            for (int j = 1; j < k; j++) {
+                xLine = _mm256_and_si256(xLine, _mm256_load_si256(x + line[j]));
+                oLine = _mm256_and_si256(oLine, _mm256_load_si256(o + line[j]));
+            }
+            xWin = _mm256_or_si256(xWin, xLine);
+            oWin = _mm256_or_si256(oWin, oLine);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(job.xWins + group * 4), xWin);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(job.oWins + group * 4), oWin);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(job.full + group * 4), filled);
+    }
+}
+#endif
+
+template <template <int> class Kernel>
+void runKernel(const BatchJob& job) {
+    // The common win lengths get an unrolled AND chain.
+    switch (job.k) {
+    case 3: Kernel<3>::run(job); break;
+    case 4: Kernel<4>::run(job); break;
+    case 5: Kernel<5>::run(job); break;
+    default: Kernel<0>::run(job); break;
+    }
+}
+
+template <int K>
+struct ScalarKernel {
+    static void run(const BatchJob& job) { evaluateScalar<K>(job); }
+};
+
+#ifdef HEX_BATCH_HAVE_AVX2
+template <int K>
+struct Avx2Kernel {
+    static void run(const BatchJob& job) { evaluateAvx2<K>(job); }
+};
+#endif
+
+} // namespace
+
+HexBoardBatch::HexBoardBatch(int radius, int k)
+    : geometry(HexGeometry::get(radius, k)),
+      cells(geometry->cellCount()),
+      boards(0) {
+    lineCells.reserve(geometry->lines.size() * k);
+    for (const HexLine& line : geometry->lines) {
+        int cell = line.start;
+        for (int step = 0; step < k; step++) {
+            lineCells.push_back(static_cast<std::int16_t>(cell));
+            cell = geometry->neighbors[cell][line.axis];
+        }
+    }
+}
+
+void HexBoardBatch::clear() {
+    boards = 0;
+    xPlanes.clear();
+    oPlanes.clear();
+}
+
+std::size_t HexBoardBatch::addEmpty() {
+    if (boards % GROUP_BOARDS == 0) {
+        // New group; resize() zero-fills its planes.
+        xPlanes.resize(xPlanes.size() + cells);
+        oPlanes.resize(oPlanes.size() + cells);
+    }
+    return boards++;
+}
+
+void HexBoardBatch::evaluate(HexBatchResults& results, HexBatchKernel kernel) const {
+    std::size_t groups = (boards + GROUP_BOARDS - 1) / GROUP_BOARDS;
+    results.xWins.resize(groups * 4);
+    results.oWins.resize(groups * 4);
+    results.full.resize(groups * 4);
+    BatchJob job;
+    job.x = xPlanes.data();
+    job.o = oPlanes.data();
+    job.groups = groups;
+    job.cells = cells;
+    job.lineCells = lineCells.data();
+    job.lines = geometry->lines.size();
+    job.k = geometry->winLength();
+    job.xWins = results.xWins.data();
+    job.oWins = results.oWins.data();
+    job.full = results.full.data();
+
+    if (kernel == BATCH_KERNEL_AUTO)
+        kernel = defaultKernel();
+#ifdef HEX_BATCH_HAVE_AVX2
+    if (kernel == BATCH_KERNEL_AVX2 && avx2Available()) {
+        runKernel<Avx2Kernel>(job);
+        return;
+    }
+#endif
+    runKernel<ScalarKernel>(job);
+}
+
+bool HexBoardBatch::avx2Available() {
+#ifdef HEX_BATCH_HAVE_AVX2
+    static const bool available = __builtin_cpu_supports("avx2");
+    return available;
+#else
+    return false;
+#endif
+}
+
+HexBatchKernel HexBoardBatch::defaultKernel() {
+    return avx2Available() ? BATCH_KERNEL_AVX2 : BATCH_KERNEL_SCALAR;
+}
+
+const char* HexBoardBatch::kernelName(HexBatchKernel kernel) {
+    switch (kernel) {
+    case BATCH_KERNEL_SCALAR: return "scalar";
+    case BATCH_KERNEL_AVX2: return "avx2";
+    default: return kernelName(defaultKernel());
+    }
+}
@@ -0,0 +1,13 @@
+// HexGraphics.cpp
+#include "HexGraphics.h"
+#include "HexGeometry.h"
+
+sf::Vector2f hexAxialToPixel(int q, int r) {
+    sf::Vector2f pixel;
+    hexAxialToPoint(q, r, HEX_SIZE, pixel.x, pixel.y);
+    return pixel;
+}
+
+void hexPixelToAxial(const sf::Vector2f& pixel, int& q, int& r) {
+    hexPointToAxial(pixel.x, pixel.y, HEX_SIZE, q, r);
+}
@@ -0,0 +1,144 @@
+// NetProtocol.cpp
+#include "NetProtocol.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool parseHostPort(const std::string& text, std::string& host, std::uint16_t& port) {
+    std::size_t colon = text.rfind(':');
+    host = text.substr(0, colon);
+    if (host.empty())
+        host = "127.0.0.1";
+    if (colon == std::string::npos)
+        return true;
+    char* end = nullptr;
+    long value = std::strtol(text.c_str() + colon + 1, &end, 10);
+    if (*end != '\0' || value < 1 || value > 65535)
+        return false;
+    port = static_cast<std::uint16_t>(value);
+    return true;
+}
+
+long raiseOpenFileLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+        return -1;
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    return static_cast<long>(limit.rlim_cur);
+}
+
+NetClient::NetClient() : fd(-1), start(0), end(0) {
+}
+
+NetClient::~NetClient() {
+    close();
+}
+
+bool NetClient::connect(const std::string& host, std::uint16_t port, std::string& error) {
+    close();
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0) {
+        error = "cannot resolve " + host;
+        return false;
+    }
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd >= 0 && ::connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+        error = "cannot connect to " + host + ":" + service;
+        return false;
+    }
+    // Moves are tiny and latency-bound; don't let Nagle hold them back.
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+void NetClient::close() {
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+    start = end = 0;
+}
+
+int NetClient::release() {
+    int socket = fd;
+    fd = -1;
+    start = end = 0;
+    return socket;
+}
+
+bool NetClient::send(const NetMessage& message) {
+    if (fd < 0)
+        return false;
+    std::uint8_t bytes[NET_MESSAGE_BYTES];
+    encodeNetMessage(message, bytes);
+    std::size_t sent = 0;
+    while (sent < sizeof(bytes)) {
+        ssize_t n = ::send(fd, bytes + sent, sizeof(bytes) - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Only possible if the server stopped reading; wait briefly for room.
+            pollfd wait = {fd, POLLOUT, 0};
+            if (poll(&wait, 1, 1000) <= 0) {
+                close();
+                return false;
+            }
+        } else if (!(n < 0 && errno == EINTR)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NetClient::fill() {
+    if (start > 0) {
+        std::memmove(buffer, buffer + start, end - start);
+        end -= start;
+        start = 0;
+    }
+    ssize_t n = ::recv(fd, buffer + end, sizeof(buffer) - end, 0);
+    if (n > 0) {
+        end += n;
+        return true;
+    }
+    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        // Keep what was received before the close; receive() still hands it out.
+        ::close(fd);
+        fd = -1;
+    }
+    return false;
+}
+
+bool NetClient::receive(NetMessage& message) {
+    if (end - start < NET_MESSAGE_BYTES && (fd < 0 || !fill() || end - start < NET_MESSAGE_BYTES))
+        return false;
+    message = decodeNetMessage(buffer + start);
+    start += NET_MESSAGE_BYTES;
+    return true;
+}
@@ -0,0 +1,198 @@
+// PositionAnalyzer.cpp
+#include "PositionAnalyzer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Control word of the snapshot double buffer.
+const unsigned CONTROL_FRONT = 1;      // Slot holding the newest snapshot
+const unsigned CONTROL_READING = 2;    // The reader is copying a slot...
+const unsigned CONTROL_READ_SLOT = 4;  // ...and this is the one (set: slot 1)
+
+const int PUBLISH_RETRY_MS = 2;        // Wait before retrying a deferred publish
+
+// Cell values as a board, for AlphaBetaSearch::setPosition().
+struct CellValues {
+    const std::vector<char>& values;
+    char valueAt(int cell) const { return values[cell]; }
+};
+
+// Best score first; ties keep their order.
+void sortBestFirst(std::vector<int>& order, const std::vector<int>& scores) {
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return scores[a] > scores[b]; });
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+double analysisWinProbability(int score, int winLength) {
+    if (score > ALPHABETA_WIN_THRESHOLD)
+        return 1.0;
+    if (score < -ALPHABETA_WIN_THRESHOLD)
+        return 0.0;
+    // Two open lines with k - 1 marks, weighted as in AlphaBetaSearch.
+    double scale = 2.0 * static_cast<double>(1LL << std::min(3 * std::max(winLength - 2, 0), 24));
+    return 1.0 / (1.0 + std::exp(-score / scale));
+}
+
+void PositionAnalyzer::start() {
+    search.setStopFlag(&cancel);
+    worker = std::thread(&PositionAnalyzer::run, this);
+}
+
+PositionAnalyzer::~PositionAnalyzer() {
+    {
+        std::lock_guard<std::mutex> lock(requestLock);
+        stopping = true;
+        cancel.store(true, std::memory_order_relaxed);
+    }
+    requestReady.notify_one();
+    worker.join();
+}
+
+std::uint64_t PositionAnalyzer::post(const std::vector<char>& values, char toMove, bool gameOver) {
+    std::uint64_t position;
+    {
+        std::lock_guard<std::mutex> lock(requestLock);
+        position = ++positions;
+        pending.position = position;
+        pending.values = values;
+        pending.toMove = toMove;
+        pending.gameOver = gameOver;
+        hasRequest = true;
+        cancel.store(true, std::memory_order_relaxed);
+    }
+    requestReady.notify_one();
+    return position;
+}
+
+void PositionAnalyzer::pause() {
+    std::lock_guard<std::mutex> lock(requestLock);
+    hasRequest = false;
+    cancel.store(true, std::memory_order_relaxed);
+}
+
+bool PositionAnalyzer::waitForRequest(Request& request) {
+    std::unique_lock<std::mutex> lock(requestLock);
+    while (!stopping && !hasRequest) {
+        if (!hasUnpublished) {
+            requestReady.wait(lock);
+            continue;
+        }
+        requestReady.wait_for(lock, std::chrono::milliseconds(PUBLISH_RETRY_MS));
+        publish(unpublished);
+    }
+    if (stopping)
+        return false;
+    std::swap(request, pending);
+    hasRequest = false;
+    cancel.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void PositionAnalyzer::run() {
+    Request request;
+    while (waitForRequest(request))
+        analyse(request);
+}
+
+void PositionAnalyzer::analyse(const Request& request) {
+    auto start = std::chrono::steady_clock::now();
+    auto lastPublish = start;
+    std::uint64_t startNodes = search.nodeCount();
+    search.setPosition(CellValues{request.values});
+
+    AnalysisSnapshot snapshot;
+    snapshot.position = request.position;
+    snapshot.toMove = request.toMove;
+    snapshot.scores.assign(cells, ANALYSIS_NO_SCORE);
+    std::vector<int> order;
+    for (int cell = 0; cell < cells; cell++) {
+        if (request.values[cell] == ' ')
+            order.push_back(cell);
+    }
+    if (request.gameOver || order.empty()) {
+        snapshot.finished = true;
+        publish(snapshot);
+        lastScores.clear();
+        return;
+    }
+    // Until the first iteration finishes, the previous position's scores are the best
+    // guess at which cells matter.
+    if (lastScores.size() == static_cast<std::size_t>(cells))
+        sortBestFirst(order, lastScores);
+
+    std::vector<int> scores(cells, ANALYSIS_NO_SCORE);
+    int maxDepth = static_cast<int>(order.size());
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        for (int cell : order) {
+            int score = search.scoreMove(request.toMove, cell, depth);
+            if (search.stopped() || cancel.load(std::memory_order_relaxed))
+                return;
+            scores[cell] = score;
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastPublish >= std::chrono::milliseconds(PUBLISH_INTERVAL_MS)) {
+                // Node rate only; the scores stay those of the last full iteration.
+                lastPublish = now;
+                snapshot.nodes = search.nodeCount() - startNodes;
+                snapshot.seconds = secondsSince(start);
+                publish(snapshot);
+            }
+        }
+        sortBestFirst(order, scores);
+        // Proven wins and losses stay proven at any depth; only heuristic scores can change.
+        bool decided = std::all_of(order.begin(), order.end(), [&](int cell) {
+            return std::abs(scores[cell]) > ALPHABETA_WIN_THRESHOLD;
+        });
+        snapshot.scores = scores;
+        snapshot.depth = depth;
+        snapshot.finished = decided || depth == maxDepth;
+        snapshot.bestMove = order.front();
+        snapshot.nodes = search.nodeCount() - startNodes;
+        snapshot.seconds = secondsSince(start);
+        lastScores = scores;
+        lastPublish = std::chrono::steady_clock::now();
+        publish(snapshot);
+        if (snapshot.finished)
+            return;
+    }
+}
+
+bool PositionAnalyzer::publish(const AnalysisSnapshot& snapshot) {
+    // The reader only ever starts on the front slot, which is not the one written here, so
+    // the check below cannot go stale before the write.
+    unsigned state = control.load(std::memory_order_acquire);
+    unsigned back = (state & CONTROL_FRONT) ^ 1;
+    bool readingBack = (state & CONTROL_READING) && ((state & CONTROL_READ_SLOT) != 0) == (back != 0);
+    if (readingBack) {
+        if (&snapshot != &unpublished)
+            unpublished = snapshot;
+        hasUnpublished = true;
+        return false;
+    }
+    slots[back] = snapshot;
+    slots[back].sequence = ++published;
+    control.fetch_xor(CONTROL_FRONT, std::memory_order_release);
+    hasUnpublished = false;
+    return true;
+}
+
+bool PositionAnalyzer::latest(AnalysisSnapshot& out) {
+    unsigned state = control.load(std::memory_order_relaxed);
+    unsigned reading;
+    do {
+        reading = state | CONTROL_READING;
+        reading = (state & CONTROL_FRONT) ? (reading | CONTROL_READ_SLOT) : (reading & ~CONTROL_READ_SLOT);
+    } while (!control.compare_exchange_weak(state, reading, std::memory_order_acquire, std::memory_order_relaxed));
+    const AnalysisSnapshot& front = slots[(reading & CONTROL_READ_SLOT) ? 1 : 0];
+    bool newer = front.sequence != out.sequence;
+    if (newer)
+        out = front;
+    control.fetch_and(~(CONTROL_READING | CONTROL_READ_SLOT), std::memory_order_release);
+    return newer;
+}
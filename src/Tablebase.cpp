@@ -0,0 +1,224 @@
+// Tablebase.cpp
+#include "Tablebase.h"
+#include "HexBoard.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char TABLEBASE_MAGIC[4] = {'H', 'X', 'T', 'B'};
+const std::size_t KEYS_PER_BUCKET = 4;
+
+static_assert(sizeof(TablebaseEntry) == 8, "entries are packed two per 16 bytes");
+static_assert(sizeof(TablebaseHeader) == 48, "the header is part of the file format");
+
+// Bytes taken by the displacement array, padded so the slots that follow are 8-byte aligned.
+std::uint64_t displacementBytes(std::uint64_t buckets) {
+    return (buckets * sizeof(std::uint32_t) + 7) & ~std::uint64_t(7);
+}
+
+// Finds a displacement for every bucket, largest buckets first (they are the hardest to place
+// while the table is still empty). Returns false if some bucket cannot be placed.
+bool placeKeys(const std::vector<TablebaseRecord>& records, std::uint64_t buckets, std::uint64_t slotCount,
+               std::vector<std::uint32_t>& displacements, std::vector<std::uint32_t>& slotRecord) {
+    // Group the records by bucket (counting sort).
+    std::vector<std::uint32_t> start(buckets + 1, 0);
+    for (const auto &record : records)
+        start[tablebaseBucket(record.key, buckets) + 1]++;
+    for (std::uint64_t b = 0; b < buckets; b++)
+        start[b + 1] += start[b];
+    std::vector<std::uint32_t> members(records.size());
+    std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+    for (std::size_t i = 0; i < records.size(); i++)
+        members[fill[tablebaseBucket(records[i].key, buckets)]++] = static_cast<std::uint32_t>(i);
+
+    std::vector<std::uint32_t> order(buckets);
+    for (std::uint64_t b = 0; b < buckets; b++)
+        order[b] = static_cast<std::uint32_t>(b);
+    std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return start[a + 1] - start[a] > start[b + 1] - start[b];
+    });
+
+    displacements.assign(buckets, 0);
+    slotRecord.assign(slotCount, UINT32_MAX);
+    std::vector<std::uint64_t> placed;
+    for (std::uint32_t bucket : order) {
+        if (start[bucket + 1] == start[bucket])
+            break;  // Only empty buckets are left
+        for (std::uint32_t d = 0;; d++) {
+            if (d == UINT32_MAX)
+                return false;
+            placed.clear();
+            bool fits = true;
+            for (std::uint32_t m = start[bucket]; m < start[bucket + 1] && fits; m++) {
+                std::uint64_t slot = tablebaseSlot(records[members[m]].key, d, slotCount);
+                fits = slotRecord[slot] == UINT32_MAX && std::find(placed.begin(), placed.end(), slot) == placed.end();
+                placed.push_back(slot);
+            }
+            if (!fits)
+                continue;
+            for (std::uint32_t m = start[bucket]; m < start[bucket + 1]; m++)
+                slotRecord[placed[m - start[bucket]]] = members[m];
+            displacements[bucket] = d;
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string describeTablebaseResult(const TablebaseResult& result, char toMove) {
+    char opponent = toMove == 'X' ? 'O' : 'X';
+    switch (result.value) {
+    case TB_WIN:
+        return std::string(1, toMove) + " wins in " + std::to_string(result.plies);
+    case TB_LOSS:
+        return std::string(1, opponent) + " wins in " + std::to_string(result.plies);
+    case TB_DRAW:
+        return "draw in " + std::to_string(result.plies);
+    case TB_ESTIMATE:
+        return std::string(1, toMove) + " scores " + std::to_string(std::lround(result.score * 100)) + "%";
+    default:
+        return "unknown";
+    }
+}
+
+bool writeTablebase(const std::string& path, int radius, int k, int depth, bool complete,
+                    const std::vector<TablebaseRecord>& records, std::string& error) {
+    if (radius < 0 || radius > MAX_BOARD_RADIUS || k < 1 || k > 255 || records.size() >= UINT32_MAX / 2) {
+        error = "unsupported table size";
+        return false;
+    }
+    // About four keys per bucket and a 94% full slot array: displacements are found quickly
+    // and the file stays close to 8 bytes per position.
+    std::uint64_t buckets = std::max<std::uint64_t>(1, (records.size() + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET);
+    std::uint64_t slotCount = records.size() + records.size() / 16 + 1;
+    std::vector<std::uint32_t> displacements;
+    std::vector<std::uint32_t> slotRecord;
+    if (!placeKeys(records, buckets, slotCount, displacements, slotRecord)) {
+        error = "no perfect hash found (duplicate keys?)";
+        return false;
+    }
+
+    TablebaseHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+    header.version = TABLEBASE_VERSION;
+    header.radius = static_cast<std::uint8_t>(radius);
+    header.winLength = static_cast<std::uint8_t>(k);
+    header.complete = complete ? 1 : 0;
+    header.depth = static_cast<std::uint32_t>(depth);
+    header.seed = TABLEBASE_KEY_SEED;
+    header.entries = records.size();
+    header.slots = slotCount;
+    header.buckets = buckets;
+
+    std::vector<TablebaseEntry> slots(slotCount);
+    std::memset(static_cast<void*>(slots.data()), 0, slots.size() * sizeof(TablebaseEntry));
+    for (std::uint64_t slot = 0; slot < slotCount; slot++) {
+        if (slotRecord[slot] == UINT32_MAX)
+            continue;
+        const TablebaseRecord& record = records[slotRecord[slot]];
+        slots[slot] = record.entry;
+        slots[slot].check = static_cast<std::uint32_t>(record.key >> 32);
+    }
+    displacements.resize(displacementBytes(buckets) / sizeof(std::uint32_t), 0);
+
+    // Written next to the target and renamed over it, so a reader never maps a partial file.
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        error = "cannot write " + temporary;
+        return false;
+    }
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(displacements.data(), sizeof(std::uint32_t), displacements.size(), file) == displacements.size() &&
+                   std::fwrite(slots.data(), sizeof(TablebaseEntry), slots.size(), file) == slots.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+Tablebase::Tablebase() : header(nullptr), displacements(nullptr), slots(nullptr), size(0) {
+}
+
+Tablebase::~Tablebase() {
+    close();
+}
+
+bool Tablebase::open(const std::string& path, std::string& error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno != ENOENT)
+            error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(TablebaseHeader)) {
+        ::close(fd);
+        error = path + " is not a tablebase";
+        return false;
+    }
+    std::size_t length = static_cast<std::size_t>(info.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    // Lookups land anywhere in the file; read-ahead would only fetch pages nobody asks for.
+    madvise(mapping, length, MADV_RANDOM);
+    const TablebaseHeader* candidate = static_cast<const TablebaseHeader*>(mapping);
+    std::uint64_t expected = sizeof(TablebaseHeader) + displacementBytes(candidate->buckets) +
+                             candidate->slots * sizeof(TablebaseEntry);
+    if (std::memcmp(candidate->magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC)) != 0 ||
+        candidate->version != TABLEBASE_VERSION || candidate->radius > MAX_BOARD_RADIUS || candidate->winLength < 1 ||
+        candidate->buckets == 0 || candidate->buckets >= UINT32_MAX || candidate->slots == 0 ||
+        candidate->slots >= UINT32_MAX || expected != length) {
+        munmap(mapping, length);
+        error = path + " is not a tablebase (or has an unsupported version)";
+        return false;
+    }
+
+    const std::uint8_t* data = static_cast<const std::uint8_t*>(mapping);
+    header = candidate;
+    displacements = reinterpret_cast<const std::uint32_t*>(data + sizeof(TablebaseHeader));
+    slots = reinterpret_cast<const TablebaseEntry*>(data + sizeof(TablebaseHeader) + displacementBytes(header->buckets));
+    size = length;
+    hasher.reset(new TablebaseHasher(DynamicHexBoard(header->radius, header->winLength), header->seed));
+    return true;
+}
+
+void Tablebase::close() {
+    if (header)
+        munmap(const_cast<TablebaseHeader*>(header), size);
+    header = nullptr;
+    displacements = nullptr;
+    slots = nullptr;
+    size = 0;
+    hasher.reset();
+}
+
+TablebaseResult Tablebase::resultFor(const TablebaseEntry& entry, int move) {
+    TablebaseResult result;
+    result.value = static_cast<TablebaseValue>(entry.value);
+    result.plies = entry.value == TB_ESTIMATE ? -1 : entry.detail;
+    result.score = entry.value == TB_WIN ? 1.0
+                 : entry.value == TB_LOSS ? 0.0
+                 : entry.value == TB_DRAW ? 0.5
+                 : entry.detail / 255.0;
+    result.bestMove = move;
+    return result;
+}
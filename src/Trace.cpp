@@ -0,0 +1,303 @@
+// Trace.cpp
+#include "Trace.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+std::atomic<bool> Tracer::active(false);
+
+namespace {
+
+// Everything the drain thread and the registration path share.
+struct TraceState {
+    std::mutex mutex;                                    // Guards everything below but the scratch space
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;   // Never freed; reused once retired
+    std::unique_ptr<TraceSink> sink;                     // Only replaced while no drain thread runs
+    std::thread drainer;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::chrono::milliseconds interval{50};
+    // Drain thread's scratch space, used without the mutex.
+    std::vector<TraceBuffer*> draining;                  // Copy of 'buffers' taken under the mutex
+    std::vector<TraceEvent> batch;
+};
+
+TraceState& state() {
+    static TraceState instance;
+    return instance;
+}
+
+// Event timestamps count from here (set by the first Tracer::start()).
+std::atomic<std::int64_t> originNanos(0);
+
+std::int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Marks the thread's buffer as retired when the thread exits, so a later thread can take it
+// over instead of registering a new one (search threads come and go every move).
+struct ThreadSlot {
+    TraceBuffer* buffer = nullptr;
+    ~ThreadSlot() {
+        if (buffer)
+            buffer->retire();
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+// Called without the state mutex, by the drain thread or by stop() once it has exited. The
+// mutex is only held to copy the buffer list, so a thread registering its first event never
+// waits for the sink's write and flush.
+void drainAll(TraceState& s) {
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.draining.clear();
+        for (auto &buffer : s.buffers)
+            s.draining.push_back(buffer.get());
+    }
+    s.batch.clear();
+    for (TraceBuffer* buffer : s.draining)
+        buffer->drain(s.batch);
+    if (s.batch.empty() || !s.sink)
+        return;
+    // Buffers are drained one after another; restore time order across threads.
+    std::stable_sort(s.batch.begin(), s.batch.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.nanos < b.nanos;
+    });
+    s.sink->write(s.batch.data(), s.batch.size());
+    s.sink->flush();
+}
+
+void drainLoop() {
+    TraceState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    while (!s.stopping) {
+        s.wake.wait_for(lock, s.interval);
+        lock.unlock();
+        drainAll(s);
+        lock.lock();
+    }
+}
+
+const char* const EVENT_NAMES[] = {
+    "?", "move", "game-over", "reset", "background", "ai", "pacing", "frame", "search", "solve", "tablebase", "startup", "analysis"
+};
+
+struct MetricRegistry {
+    std::mutex mutex;
+    std::vector<const MetricCounter*> counters;
+    std::vector<const MetricGauge*> gauges;
+};
+
+MetricRegistry& registry() {
+    static MetricRegistry instance;
+    return instance;
+}
+
+} // namespace
+
+int formatTraceEvent(const TraceEvent& event, char* out, std::size_t size) {
+    const char* name = event.type < sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) ? EVENT_NAMES[event.type] : "?";
+    const std::int32_t* a = event.args;
+    int prefix = std::snprintf(out, size, "[%12.6f] t%-2u %-10s ", event.nanos / 1e9, event.thread, name);
+    if (prefix < 0 || static_cast<std::size_t>(prefix) >= size)
+        return prefix;
+    char* rest = out + prefix;
+    std::size_t space = size - prefix;
+    int written;
+    switch (event.type) {
+    case TRACE_MOVE:
+        written = std::snprintf(rest, space, "%c cell %d (%d,%d)", a[1], a[0], a[2], a[3]);
+        break;
+    case TRACE_GAME_OVER:
+        written = a[0] == 'D' ? std::snprintf(rest, space, "draw after %d moves", a[1])
+                              : std::snprintf(rest, space, "%c wins after %d moves", a[0], a[1]);
+        break;
+    case TRACE_RESET:
+        written = std::snprintf(rest, space, "after %d moves", a[0]);
+        break;
+    case TRACE_BACKGROUND:
+        written = std::snprintf(rest, space, "%s", a[0] ? "white" : "black");
+        break;
+    case TRACE_AI:
+        written = std::snprintf(rest, space, "%s", a[0] ? "enabled" : "disabled");
+        break;
+    case TRACE_PACING:
+        written = std::snprintf(rest, space, "%s", a[0] ? "capped" : "event-driven");
+        break;
+    case TRACE_FRAME:
+        written = std::snprintf(rest, space, "events %d us, draw %d us%s", a[0], a[1], a[2] ? "" : " (skipped)");
+        break;
+    case TRACE_SEARCH:
+        written = std::snprintf(rest, space, "%d playouts, %d nodes, %d ms, best cell %d", a[0], a[1], a[2], a[3]);
+        break;
+    case TRACE_SOLVE:
+        written = std::snprintf(rest, space, "%d nodes, %d ms, score %d, best cell %d", a[0], a[1], a[2], a[3]);
+        break;
+    case TRACE_TABLEBASE:
+        written = std::snprintf(rest, space, "%d entries (%s), opened in %d us", a[0], a[2] ? "complete" : "partial", a[1]);
+        break;
+    case TRACE_STARTUP:
+        written = std::snprintf(rest, space, "first frame after %d us (fonts %d us, %d glyphs in %d us)",
+                                a[0], a[1], a[3], a[2]);
+        break;
+    case TRACE_ANALYSIS:
+        written = std::snprintf(rest, space, "%s", a[0] ? "enabled" : "disabled");
+        break;
+    default:
+        written = std::snprintf(rest, space, "%d %d %d %d %d", a[0], a[1], a[2], a[3], a[4]);
+        break;
+    }
+    return written < 0 ? written : prefix + written;
+}
+
+void TextTraceSink::write(const TraceEvent* events, std::size_t count) {
+    char line[160];
+    for (std::size_t i = 0; i < count; i++) {
+        if (formatTraceEvent(events[i], line, sizeof(line)) >= 0)
+            std::fprintf(out, "%s\n", line);
+    }
+}
+
+BinaryTraceSink::BinaryTraceSink(const std::string& path) : file(std::fopen(path.c_str(), "wb")) {
+    if (!file)
+        return;
+    std::uint8_t header[8] = {'H', 'X', 'T', 'R', 1, 0, 0, 0};
+    std::uint16_t eventSize = sizeof(TraceEvent);
+    std::memcpy(header + 6, &eventSize, sizeof(eventSize));
+    std::fwrite(header, 1, sizeof(header), file);
+}
+
+BinaryTraceSink::~BinaryTraceSink() {
+    if (file)
+        std::fclose(file);
+}
+
+void BinaryTraceSink::write(const TraceEvent* events, std::size_t count) {
+    if (file)
+        std::fwrite(events, sizeof(TraceEvent), count, file);
+}
+
+void BinaryTraceSink::flush() {
+    if (file)
+        std::fflush(file);
+}
+
+void Tracer::start(std::unique_ptr<TraceSink> sink, std::chrono::milliseconds interval) {
+    stop();
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (originNanos.load() == 0)
+        originNanos.store(steadyNanos());
+    s.sink = std::move(sink);
+    s.interval = interval;
+    s.stopping = false;
+    s.drainer = std::thread(drainLoop);
+    active.store(true, std::memory_order_release);
+}
+
+void Tracer::stop() {
+    TraceState& s = state();
+    active.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.drainer.joinable())
+            return;
+        s.stopping = true;
+    }
+    s.wake.notify_all();
+    s.drainer.join();
+    drainAll(s);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.sink.reset();
+}
+
+void Tracer::emit(TraceEventType type, std::int32_t a, std::int32_t b, std::int32_t c, std::int32_t d, std::int32_t e) {
+    TraceBuffer* buffer = threadSlot.buffer;
+    if (!buffer) {
+        // First event from this thread: adopt a retired, fully drained buffer, or add one.
+        TraceState& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        for (auto &candidate : s.buffers) {
+            if (candidate->retired.load(std::memory_order_acquire) && candidate->empty()) {
+                candidate->retired.store(false, std::memory_order_relaxed);
+                buffer = candidate.get();
+                break;
+            }
+        }
+        if (!buffer) {
+            s.buffers.emplace_back(new TraceBuffer(static_cast<std::uint16_t>(s.buffers.size())));
+            buffer = s.buffers.back().get();
+        }
+        threadSlot.buffer = buffer;
+    }
+    TraceEvent event;
+    event.nanos = static_cast<std::uint64_t>(steadyNanos() - originNanos.load(std::memory_order_relaxed));
+    event.type = type;
+    event.args[0] = a;
+    event.args[1] = b;
+    event.args[2] = c;
+    event.args[3] = d;
+    event.args[4] = e;
+    buffer->push(event);
+}
+
+std::uint64_t Tracer::droppedEvents() {
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::uint64_t total = 0;
+    for (const auto &buffer : s.buffers)
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+MetricCounter::MetricCounter(const char* name) : label(name), count(0) {
+    MetricRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.counters.push_back(this);
+}
+
+MetricGauge::MetricGauge(const char* name) : label(name), current(0.0) {
+    MetricRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.gauges.push_back(this);
+}
+
+std::vector<MetricValue> Metrics::snapshot() {
+    MetricRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<MetricValue> values;
+    for (const MetricCounter* counter : r.counters)
+        values.push_back(MetricValue{counter->name(), static_cast<double>(counter->get())});
+    for (const MetricGauge* gauge : r.gauges)
+        values.push_back(MetricValue{gauge->name(), gauge->get()});
+    return values;
+}
+
+std::string Metrics::summary() {
+    std::string text;
+    char value[32];
+    for (const MetricValue& metric : snapshot()) {
+        std::snprintf(value, sizeof(value), "%.15g", metric.value);
+        if (!text.empty())
+            text += ' ';
+        text += metric.name + "=" + value;
+    }
+    return text;
+}
+
+namespace metrics {
+MetricCounter movesPlayed("game.moves");
+MetricCounter gamesFinished("game.finished");
+MetricCounter searches("mcts.searches");
+MetricCounter playouts("mcts.playouts");
+MetricCounter solverNodes("solver.nodes");
+MetricCounter tablebaseHits("tablebase.hits");
+MetricGauge playoutsPerSecond("mcts.playouts_per_sec");
+MetricGauge frameDrawMicros("frame.draw_us");
+MetricGauge firstFrameMillis("startup.first_frame_ms");
+}
@@ -0,0 +1,50 @@
+// TranspositionTable.cpp
+#include "TranspositionTable.h"
+#include <cstring>
+
+static_assert(sizeof(TTEntry) == 16, "four entries must fill one cache line");
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) : mask(0), generation(0) {
+    // Round down to a power-of-two bucket count so the index is a mask of the key.
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+        count *= 2;
+    buckets.resize(count);
+    mask = count - 1;
+    clear();
+}
+
+const TTEntry* TranspositionTable::probe(std::uint64_t key) const {
+    const Bucket &bucket = buckets[key & mask];
+    for (const auto &entry : bucket.entries) {
+        if (entry.key == key && entry.bound != TT_NONE)
+            return &entry;
+    }
+    return nullptr;
+}
+
+void TranspositionTable::store(std::uint64_t key, int score, int move, TTBound bound, int depth) {
+    Bucket &bucket = buckets[key & mask];
+    TTEntry *victim = &bucket.entries[0];
+    for (auto &entry : bucket.entries) {
+        if (entry.key == key || entry.bound == TT_NONE) {
+            victim = &entry;
+            break;
+        }
+        // Prefer evicting stale entries, then shallow ones.
+        bool entryStale = entry.generation != generation;
+        bool victimStale = victim->generation != generation;
+        if (entryStale != victimStale ? entryStale : entry.depth < victim->depth)
+            victim = &entry;
+    }
+    victim->key = key;
+    victim->score = static_cast<std::int16_t>(score);
+    victim->move = static_cast<std::int16_t>(move);
+    victim->bound = bound;
+    victim->depth = static_cast<std::uint8_t>(depth > 255 ? 255 : depth);
+    victim->generation = generation;
+}
+
+void TranspositionTable::clear() {
+    std::memset(static_cast<void*>(buckets.data()), 0, buckets.size() * sizeof(Bucket));
+}
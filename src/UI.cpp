@@ -1,76 +1,129 @@
 // UI.cpp
 #include "UI.h"
+#ifdef HEX_EMBEDDED_FONTS
+#include "EmbeddedAssets.h"
+#endif
 #include <iostream>
 
+namespace {
+
+// Offset of the drop shadow, in screen pixels (not affected by the label's scale).
+const float SHADOW_OFFSET = 2.0f;
+
+// Glyphs rendered ahead of time for each text style: printable ASCII.
+const sf::Uint32 FIRST_WARM_GLYPH = 32;
+const sf::Uint32 LAST_WARM_GLYPH = 126;
+
+const char* const FONT_PATHS[2] = {"assets/Arial.ttf", "assets/Cursive.ttf"};
+
+sf::Font fonts[2];
+bool fontOk[2] = {false, false};
+FontLoadStats loadStats = {false, 0.0, 0.0, 0};
+bool fontsLoaded = false;
+
+bool loadFont(UIFont id) {
+#ifdef HEX_EMBEDDED_FONTS
+    // The embedded bytes are static, so they outlive the font as loadFromMemory requires.
+    const EmbeddedAsset& asset = id == FONT_STANDARD ? EMBEDDED_FONT_STANDARD : EMBEDDED_FONT_CURSIVE;
+    if (fonts[id].loadFromMemory(asset.data, asset.size))
+        return true;
+    std::cerr << "Failed to load embedded font " << FONT_PATHS[id] << std::endl;
+#else
+    if (fonts[id].loadFromFile(FONT_PATHS[id]))
+        return true;
+    std::cerr << "Failed to load font " << FONT_PATHS[id] << std::endl;
+#endif
+    return false;
+}
+
+} // namespace
+
+bool UI::loadFonts() {
+    if (fontsLoaded)
+        return loadStats.loaded;
+    fontsLoaded = true;
+
+    sf::Clock clock;
+    fontOk[FONT_STANDARD] = loadFont(FONT_STANDARD);
+    fontOk[FONT_CURSIVE] = loadFont(FONT_CURSIVE);
+    loadStats.loaded = fontOk[FONT_STANDARD] && fontOk[FONT_CURSIVE];
+    loadStats.loadSeconds = clock.restart().asSeconds();
+
+    for (const UITextStyle& style : UI_TEXT_STYLES) {
+        if (!fontOk[style.font])
+            continue;
+        for (sf::Uint32 c = FIRST_WARM_GLYPH; c <= LAST_WARM_GLYPH; c++) {
+            fonts[style.font].getGlyph(c, style.size, false);
+            loadStats.glyphs++;
+        }
+    }
+    loadStats.warmSeconds = clock.getElapsedTime().asSeconds();
+    return loadStats.loaded;
+}
+
+const FontLoadStats& UI::fontLoadStats() {
+    return loadStats;
+}
+
+const sf::Font& UI::font(UIFont id) {
+    loadFonts();
+    return fonts[id];
+}
+
 // Standard font for general UI text.
 void UI::drawText(sf::RenderWindow& window, const std::string& text,
                   int centerX, int centerY, int size, sf::Color color, float scale) {
-    static sf::Font font;
-    static bool isFontLoaded = false;
-    if (!isFontLoaded) {
-        if (!font.loadFromFile("assets/Arial.ttf")) {
-            std::cerr << "Failed to load font assets/Arial.ttf" << std::endl;
-            return;
-        }
-        isFontLoaded = true;
-    }
-    
-    sf::Text uiText;
-    uiText.setFont(font);
-    uiText.setString(text);
-    uiText.setCharacterSize(size);
-    uiText.setFillColor(color);
-    
-    // Center the text.
-    sf::FloatRect textRect = uiText.getLocalBounds();
-    uiText.setOrigin(textRect.left + textRect.width / 2.0f,
-                     textRect.top + textRect.height / 2.0f);
-    uiText.setPosition(static_cast<float>(centerX), static_cast<float>(centerY));
-    
-    // Apply scaling for animation.
-    uiText.setScale(scale, scale);
-    
-    // Draw a drop shadow for improved visibility.
-    sf::Text shadowText = uiText;
-    shadowText.setFillColor(sf::Color::Black);
-    shadowText.move(2, 2);
-    window.draw(shadowText);
-    
-    window.draw(uiText);
+    TextLabel label;
+    label.setContent(text, FONT_STANDARD, size, color);
+    label.setCenter(static_cast<float>(centerX), static_cast<float>(centerY));
+    label.setScale(scale);
+    window.draw(label);
 }
 
 // Winner text drawn with a cursive font.
 void UI::drawWinnerText(sf::RenderWindow& window, const std::string& text,
                         int centerX, int centerY, int size, sf::Color color, float scale) {
-    static sf::Font cursiveFont;
-    static bool isCursiveLoaded = false;
-    if (!isCursiveLoaded) {
-        if (!cursiveFont.loadFromFile("assets/Cursive.ttf")) {
-            std::cerr << "Failed to load font assets/Cursive.ttf" << std::endl;
-            return;
-        }
-        isCursiveLoaded = true;
-    }
-    
-    sf::Text winnerText;
-    winnerText.setFont(cursiveFont);
-    winnerText.setString(text);
-    winnerText.setCharacterSize(size);
-    winnerText.setFillColor(color);
-    
-    // Center the text.
-    sf::FloatRect textRect = winnerText.getLocalBounds();
-    winnerText.setOrigin(textRect.left + textRect.width / 2.0f,
-                         textRect.top + textRect.height / 2.0f);
-    winnerText.setPosition(static_cast<float>(centerX), static_cast<float>(centerY));
+    TextLabel label;
+    label.setContent(text, FONT_CURSIVE, size, color);
+    label.setCenter(static_cast<float>(centerX), static_cast<float>(centerY));
+    label.setScale(scale);
+    window.draw(label);
+}
+
+TextLabel::TextLabel() : fontId(FONT_STANDARD), size(0), layouts(0) {
+}
+
+bool TextLabel::setContent(const std::string& newText, UIFont newFont, int newSize, sf::Color newColor) {
+    if (layouts > 0 && newText == text && newFont == fontId && newSize == size && newColor == color)
+        return false;
+    text = newText;
+    fontId = newFont;
+    size = newSize;
+    color = newColor;
+
+    label.setFont(UI::font(fontId));
+    label.setString(text);
+    label.setCharacterSize(size);
+    label.setFillColor(color);
     
-    winnerText.setScale(scale, scale);
+    // Center the text on its origin; the label's position is applied at draw time.
+    sf::FloatRect textRect = label.getLocalBounds();
+    label.setOrigin(textRect.left + textRect.width / 2.0f,
+                    textRect.top + textRect.height / 2.0f);
     
-    // Draw a drop shadow.
-    sf::Text shadowText = winnerText;
-    shadowText.setFillColor(sf::Color::Black);
-    shadowText.move(2, 2);
-    window.draw(shadowText);
+    // The drop shadow shares the layout, in black.
+    shadow = label;
+    shadow.setFillColor(sf::Color::Black);
+    layouts++;
+    return true;
+}
+
+void TextLabel::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    sf::RenderStates shadowStates = states;
+    shadowStates.transform.translate(SHADOW_OFFSET, SHADOW_OFFSET);
+    shadowStates.transform *= placement.getTransform();
+    target.draw(shadow, shadowStates);
     
-    window.draw(winnerText);
+    states.transform *= placement.getTransform();
+    target.draw(label, states);
 }
@@ -0,0 +1,120 @@
+// WorkStealingPool.cpp
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+
+// The pool and worker index of the calling thread, if it is a pool worker.
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local int currentWorker = -1;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : queued(0), pending(0), nextQueue(0), stolen(0), stopping(false) {
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int i = 0; i < threadCount; i++)
+        queues.emplace_back(new WorkerQueue());
+    for (int i = 0; i < threadCount; i++)
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+}
+
+void WorkStealingPool::submit(Task task) {
+    int worker = currentPool == this
+        ? currentWorker
+        : static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+    pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        WorkerQueue& queue = *queues[worker];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        queue.tasks.push_back(std::move(task));
+        queued.fetch_add(1, std::memory_order_release);
+    }
+    // Taking the sleep lock orders this with a worker that has just found every deque empty
+    // and is about to wait, so the notification cannot be lost.
+    { std::lock_guard<std::mutex> lock(sleepLock); }
+    wake.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepLock);
+    idle.wait(lock, [this]() { return pending.load(std::memory_order_acquire) == 0; });
+}
+
+void WorkStealingPool::parallelFor(std::size_t count, std::size_t grain, const RangeTask& fn) {
+    if (count == 0)
+        return;
+    grain = std::max<std::size_t>(grain, 1);
+    const RangeTask* body = &fn;  // Outlives every piece: wait() returns after the last one
+    submit([this, count, grain, body](int worker) { splitRange(0, count, grain, body, worker); });
+    wait();
+}
+
+void WorkStealingPool::splitRange(std::size_t begin, std::size_t end, std::size_t grain, const RangeTask* fn,
+                                  int worker) {
+    // Hand the upper half to the deque (where a thief can take it) and keep going on the lower.
+    while (end - begin > grain) {
+        std::size_t mid = begin + (end - begin) / 2;
+        submit([this, mid, end, grain, fn](int w) { splitRange(mid, end, grain, fn, w); });
+        end = mid;
+    }
+    (*fn)(begin, end, worker);
+}
+
+bool WorkStealingPool::takeTask(int worker, Task& task) {
+    {
+        WorkerQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    int count = size();
+    for (int i = 1; i < count; i++) {
+        WorkerQueue& victim = *queues[(worker + i) % count];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int worker) {
+    currentPool = this;
+    currentWorker = worker;
+    Task task;
+    for (;;) {
+        if (takeTask(worker, task)) {
+            task(worker);
+            task = nullptr;
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                { std::lock_guard<std::mutex> lock(sleepLock); }
+                idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepLock);
+        wake.wait(lock, [this]() { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping)
+            return;
+    }
+}
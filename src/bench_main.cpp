@@ -0,0 +1,467 @@
+// --- bench_main.cpp ---
+// Microbenchmarks for the board, the solver and the renderer. Each benchmark is run for at
+// least --min-time seconds and reported as JSON (ns/op, ops/sec, heap allocations per op),
+// so results from two builds can be diffed. Everything but the rendering benchmarks needs
+// only hexttt_core; those are compiled in with HEX_BENCH_RENDER (CMake sets it when SFML is
+// found) and skipped if no OpenGL context is available.
+//
+//   hex_bench [--filter <substring>] [--min-time <seconds>] [--out <file.json>]
+#include "HexBoard.h"
+#include "HexBoardBatch.h"
+#include "HexSolver.h"
+#ifdef HEX_BENCH_RENDER
+#include "BoardRenderer.h"
+#include "Game.h"
+#include "HexGraphics.h"
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Every heap allocation in the process goes through these, so the harness can report
+// allocations per operation.
+static std::atomic<std::uint64_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t alignment = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align) { return operator new(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+const float CELL_SIZE = 50.0f;  // Hexagon size for the pixel conversions (the game's HEX_SIZE)
+
+struct BenchResult {
+    std::string name;
+    int radius;            // Board radius, or 0 if the benchmark is not tied to a board size
+    int winLength;
+    std::uint64_t ops;     // Operations timed
+    double seconds;
+    double nsPerOp;
+    double opsPerSecond;
+    double allocsPerOp;
+};
+
+struct BenchOptions {
+    std::string filter;    // Only run benchmarks whose name contains this
+    double minSeconds;     // Minimum measured time per benchmark
+};
+
+// Keeps a value alive so the optimizer cannot drop the work that produced it.
+template <class T>
+inline void keepAlive(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Small, allocation-free generator for per-op randomness (xorshift64*).
+struct BenchRng {
+    std::uint64_t state;
+    explicit BenchRng(std::uint64_t seed) : state(seed | 1) {}
+    std::uint32_t next(std::uint32_t bound) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<std::uint32_t>(((state * 0x2545F4914F6CDD1DULL) >> 32) * bound >> 32);
+    }
+};
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options) : options(options), failures(0) {}
+
+    // Runs 'batch' (which performs some operations and returns how many) until at least
+    // minSeconds have elapsed, after one untimed warm-up call.
+    template <class Batch>
+    void run(const std::string& name, int radius, int winLength, Batch&& batch) {
+        if (!selected(name))
+            return;
+        batch();
+        std::uint64_t ops = 0;
+        std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        double seconds = 0;
+        do {
+            ops += batch();
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (seconds < options.minSeconds);
+        std::uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        BenchResult result;
+        result.name = name;
+        result.radius = radius;
+        result.winLength = winLength;
+        result.ops = ops;
+        result.seconds = seconds;
+        result.nsPerOp = seconds * 1e9 / ops;
+        result.opsPerSecond = ops / seconds;
+        result.allocsPerOp = static_cast<double>(allocations) / ops;
+        results.push_back(result);
+        std::fprintf(stderr, "%-20s r=%-3d k=%d  %12.1f ns/op  %14.0f ops/s  %6.2f allocs/op\n",
+                     name.c_str(), radius, winLength, result.nsPerOp, result.opsPerSecond, result.allocsPerOp);
+    }
+
+    bool selected(const std::string& name) const { return name.find(options.filter) != std::string::npos; }
+
+    // Reports a benchmark whose results were wrong; main() then exits with an error.
+    void fail(const std::string& message) {
+        std::cerr << "FAILED: " << message << std::endl;
+        failures++;
+    }
+    bool passed() const { return failures == 0; }
+
+    void writeJson(std::ostream& out) const {
+        out << "{\n";
+        out << "  \"context\": {\"hardware_threads\": " << std::thread::hardware_concurrency()
+            << ", \"min_time_seconds\": " << options.minSeconds << "},\n";
+        out << "  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            char line[512];
+            std::snprintf(line, sizeof(line),
+                          "    {\"name\": \"%s\", \"radius\": %d, \"win_length\": %d, \"ops\": %llu, "
+                          "\"seconds\": %.6f, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, \"allocs_per_op\": %.4f}",
+                          r.name.c_str(), r.radius, r.winLength, static_cast<unsigned long long>(r.ops),
+                          r.seconds, r.nsPerOp, r.opsPerSecond, r.allocsPerOp);
+            out << line << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    BenchOptions options;
+    std::vector<BenchResult> results;
+    int failures;
+};
+
+// A random position with about half the cells filled and no winner, so checkWinner() has to
+// scan every line.
+template <class Board>
+Board halfFilledPosition(const Board& empty, std::mt19937& rng) {
+    std::vector<int> order(empty.cellCount());
+    for (int i = 0; i < empty.cellCount(); i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    Board board = empty;
+    char player = 'X';
+    for (int cell : order) {
+        if (board.moveCount() * 2 >= board.cellCount())
+            break;
+        Board next = board;
+        next.makeMoveAt(cell, player);
+        if (next.checkWinnerAt(cell) != ' ')
+            continue;
+        board = next;
+        player = (player == 'X') ? 'O' : 'X';
+    }
+    return board;
+}
+
+// A position with a random number of random moves, played without stopping at a win, so
+// some have a winner (occasionally both players have a line) and some are full.
+template <class Board>
+Board randomPosition(const Board& empty, std::mt19937& rng) {
+    std::vector<int> order(empty.cellCount());
+    for (int i = 0; i < empty.cellCount(); i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    int moves = std::uniform_int_distribution<int>(0, empty.cellCount())(rng);
+    Board board = empty;
+    for (int i = 0; i < moves; i++)
+        board.makeMoveAt(order[i], i % 2 == 0 ? 'X' : 'O');
+    return board;
+}
+
+// checkWinner() and isFull() on many independent positions: one board at a time, then as a
+// bit-sliced HexBoardBatch with each available kernel. One op is one board, so ops/s is
+// boards/s. Half the positions are half filled with no winner (checkWinner()'s worst case),
+// half random; the batch's answers are checked against the boards' first.
+template <class Board>
+void benchBatch(BenchRunner& runner, const Board& empty) {
+    if (!runner.selected("batch") && !runner.selected("checkWinnerEach"))
+        return;
+    const int radius = empty.radius();
+    const int k = empty.winLength();
+    const std::size_t BOARDS = 4096;
+    // Half-filled positions are slow to generate on large boards; repeat a few of them.
+    const std::size_t DISTINCT = empty.cellCount() <= 400 ? BOARDS : 64;
+    std::mt19937 rng(4242);
+    std::vector<Board> distinct;
+    for (std::size_t i = 0; i < DISTINCT; i++)
+        distinct.push_back(i % 2 == 0 ? halfFilledPosition(empty, rng) : randomPosition(empty, rng));
+    std::vector<Board> positions;
+    HexBoardBatch batch(radius, k);
+    for (std::size_t i = 0; i < BOARDS; i++) {
+        positions.push_back(distinct[i % DISTINCT]);
+        batch.add(positions.back());
+    }
+
+    HexBatchResults results;
+    const HexBatchKernel kernels[] = {BATCH_KERNEL_SCALAR, BATCH_KERNEL_AVX2};
+    for (HexBatchKernel kernel : kernels) {
+        if (kernel == BATCH_KERNEL_AVX2 && !HexBoardBatch::avx2Available())
+            continue;
+        batch.evaluate(results, kernel);
+        for (std::size_t i = 0; i < BOARDS; i++) {
+            if (results.winner(i) != positions[i].checkWinner() || results.isFull(i) != positions[i].isFull()) {
+                runner.fail(std::string("HexBoardBatch (") + HexBoardBatch::kernelName(kernel) + ") disagrees with checkWinner() on r=" +
+                            std::to_string(radius) + " board " + std::to_string(i));
+                break;
+            }
+        }
+    }
+
+    runner.run("checkWinnerEach", radius, k, [&]() -> std::uint64_t {
+        for (const Board& position : positions) {
+            char winner = position.checkWinner();
+            bool full = position.isFull();
+            keepAlive(winner);
+            keepAlive(full);
+        }
+        return BOARDS;
+    });
+    runner.run("batchScalar", radius, k, [&]() -> std::uint64_t {
+        batch.evaluate(results, BATCH_KERNEL_SCALAR);
+        keepAlive(results.xWins[0]);
+        return BOARDS;
+    });
+    if (HexBoardBatch::avx2Available()) {
+        runner.run("batchAvx2", radius, k, [&]() -> std::uint64_t {
+            batch.evaluate(results, BATCH_KERNEL_AVX2);
+            keepAlive(results.xWins[0]);
+            return BOARDS;
+        });
+    }
+}
+
+// Board operations, random playouts and click hit-testing for one board size.
+template <class Board>
+void benchBoard(BenchRunner& runner, const Board& empty) {
+    const int radius = empty.radius();
+    const int k = empty.winLength();
+    const int cells = empty.cellCount();
+    std::mt19937 rng(12345);
+
+    std::vector<HexCell> moves;
+    for (const auto &cell : empty.getCells())
+        moves.push_back(cell);
+    std::shuffle(moves.begin(), moves.end(), rng);
+    Board position = halfFilledPosition(empty, rng);
+
+    // Fills a copy of the empty board in random order; the copy is part of the cost.
+    runner.run("makeMove", radius, k, [&]() -> std::uint64_t {
+        Board board = empty;
+        char player = 'X';
+        for (const auto &cell : moves) {
+            board.makeMove(cell.q, cell.r, player);
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        keepAlive(board);
+        return cells;
+    });
+
+    runner.run("checkWinner", radius, k, [&]() -> std::uint64_t {
+        for (int i = 0; i < 16; i++) {
+            keepAlive(position);
+            char winner = position.checkWinner();
+            keepAlive(winner);
+        }
+        return 16;
+    });
+
+    runner.run("checkWinnerAfter", radius, k, [&]() -> std::uint64_t {
+        for (const auto &cell : moves) {
+            char winner = position.checkWinnerAfter(cell.q, cell.r);
+            keepAlive(winner);
+        }
+        return cells;
+    });
+
+    runner.run("isFull", radius, k, [&]() -> std::uint64_t {
+        for (int i = 0; i < 1024; i++) {
+            keepAlive(position);
+            bool full = position.isFull();
+            keepAlive(full);
+        }
+        return 1024;
+    });
+
+    runner.run("axialToPixel", radius, k, [&]() -> std::uint64_t {
+        for (const auto &cell : moves) {
+            float x, y;
+            hexAxialToPoint(cell.q, cell.r, CELL_SIZE, x, y);
+            keepAlive(x);
+            keepAlive(y);
+        }
+        return cells;
+    });
+
+    // One op is a whole game: random moves, each followed by the incremental win check.
+    BenchRng playoutRng(777);
+    std::vector<int> order(cells);
+    runner.run("playout", radius, k, [&]() -> std::uint64_t {
+        for (int i = 0; i < cells; i++)
+            order[i] = i;
+        Board board = empty;
+        char player = 'X';
+        for (int remaining = cells; remaining > 0; remaining--) {
+            int pick = static_cast<int>(playoutRng.next(static_cast<std::uint32_t>(remaining)));
+            int cell = order[pick];
+            order[pick] = order[remaining - 1];
+            board.makeMoveAt(cell, player);
+            if (board.checkWinnerAt(cell) != ' ')
+                break;
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        keepAlive(board);
+        return 1;
+    });
+
+    // Random points over the board's bounding box, including the gaps around it.
+    float extent = CELL_SIZE * (1.5f * radius + 1.0f);
+    std::uniform_real_distribution<float> coordinate(-extent, extent);
+    std::vector<std::pair<float, float>> points(4096);
+    for (auto &point : points) {
+        float x = coordinate(rng);
+        point = std::make_pair(x, coordinate(rng) * 1.2f);
+    }
+    runner.run("hitTest", radius, k, [&]() -> std::uint64_t {
+        for (const auto &point : points) {
+            int q, r;
+            hexPointToAxial(point.first, point.second, CELL_SIZE, q, r);
+            int index = empty.cellIndex(q, r);
+            keepAlive(index);
+        }
+        return points.size();
+    });
+}
+
+#ifdef HEX_BENCH_RENDER
+// One op is one offscreen frame: clear, draw the cached board geometry, display.
+template <class Board>
+void benchBoardRender(BenchRunner& runner, const Board& empty, sf::RenderTexture& texture) {
+    std::mt19937 rng(12345);
+    Board position = halfFilledPosition(empty, rng);
+    BoardRenderer renderer;
+    renderer.build(position);
+    // Scale the board to fit the surface so every size covers a similar number of pixels.
+    float extent = HEX_SIZE * (2.0f * empty.radius() + 2.0f);
+    sf::Vector2f size(texture.getSize());
+    float scale = std::min(size.x, size.y) / extent;
+    renderer.setScale(scale, scale);
+    renderer.setPosition(size.x / 2, size.y / 2);
+    runner.run("renderBoard", empty.radius(), empty.winLength(), [&]() -> std::uint64_t {
+        texture.clear(sf::Color::Black);
+        texture.draw(renderer);
+        texture.display();
+        return 1;
+    });
+}
+#endif
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    options.minSeconds = 0.25;
+    std::string outPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.minSeconds = std::atof(argv[++i]);
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::cerr << "Usage: hex_bench [--filter <substring>] [--min-time <seconds>] [--out <file.json>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Board sizes: the game board, the compile-time specialisations, and one size that only
+    // the runtime-sized board handles.
+    const int sizes[][2] = {{2, 3}, {7, 4}, {10, 5}, {25, 5}, {50, 5}};
+
+    BenchRunner runner(options);
+    for (const auto &size : sizes)
+        withHexBoard(size[0], size[1], [&](const auto& empty) { benchBoard(runner, empty); });
+    for (const auto &size : sizes)
+        withHexBoard(size[0], size[1], [&](const auto& empty) { benchBatch(runner, empty); });
+
+    // Solving the empty game board from scratch; a fresh solver (and transposition table)
+    // per op so no result is reused.
+    runner.run("solve", BOARD_RADIUS, WIN_LENGTH, []() -> std::uint64_t {
+        GameBoard board;
+        HexSolver<GameBoard> solver(board, 1);
+        SolveResult result = solver.solve(board);
+        keepAlive(result);
+        return 1;
+    });
+
+#ifdef HEX_BENCH_RENDER
+    const unsigned width = 1920, height = 1080;
+    sf::RenderTexture texture;
+    if (texture.create(width, height)) {
+        for (const auto &size : sizes)
+            withHexBoard(size[0], size[1], [&](const auto& empty) { benchBoardRender(runner, empty, texture); });
+
+        // A full game frame (board, text and panels) as the windowed game draws it.
+        Game game(sf::Vector2u(width, height));
+        runner.run("gameDraw", BOARD_RADIUS, WIN_LENGTH, [&]() -> std::uint64_t {
+            game.drawFrame(texture);
+            texture.display();
+            return 1;
+        });
+    } else {
+        std::cerr << "No OpenGL context for an offscreen render texture; skipping rendering benchmarks." << std::endl;
+    }
+#else
+    std::cerr << "Built without SFML; skipping rendering benchmarks." << std::endl;
+#endif
+
+    if (outPath.empty()) {
+        runner.writeJson(std::cout);
+    } else {
+        std::ofstream out(outPath);
+        runner.writeJson(out);
+        if (!out) {
+            std::cerr << "Failed to write " << outPath << std::endl;
+            return 1;
+        }
+    }
+    return runner.passed() ? 0 : 2;
+}
@@ -0,0 +1,282 @@
+// --- engine_main.cpp ---
+// Headless engine: a line-based text protocol over stdin/stdout, built on hexttt_core only
+// (no SFML, no window). Every command produces exactly one reply line; failures reply
+// "error <message>". Cells are written "q,r" in axial coordinates, as in hex_solve.
+//
+//   newgame [radius k]   -> ok                  empty board (default: the game board, 2 3)
+//   position [q,r ...]   -> ok                  empty board of the current size plus moves;
+//                                               unchanged if any move is illegal
+//   play q,r             -> ok                  move for the side to move
+//   winner               -> winner X|O|draw|none
+//   tomove               -> tomove X|O|none     none once the game is over
+//   board                -> board <cells>       one of . X O per cell, in cell-index order
+//   legal                -> legal q,r ...       every empty cell (empty list once the game is over)
+//   go [milliseconds]    -> bestmove q,r        default 1000 ms
+//   tablebase <file>     -> ok                  answer go from a table (see hex_tablebase) where it can
+//   isready              -> readyok
+//   metrics              -> metrics <name=value ...>   counters and gauges (see Trace.h)
+//   quit
+//
+// Output is flushed whenever no further input is already buffered, so a script that pipes
+// in a batch of commands is not slowed down by a write per reply.
+#include "HexBoard.h"
+#include "HexSolver.h"
+#include "MctsEngine.h"
+#include "Tablebase.h"
+#include "Trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+const double DEFAULT_MOVE_MILLISECONDS = 1000.0;
+const std::size_t SOLVER_TABLE_MEGABYTES = 16;
+
+// One game on a board whose type was picked at runtime (see withHexBoard).
+class EngineSession {
+public:
+    virtual ~EngineSession() {}
+
+    virtual int cellIndex(int q, int r) const = 0;
+    virtual int cellCount() const = 0;
+    virtual HexCell cellAt(int index) const = 0;
+    // Back to an empty board.
+    virtual void reset() = 0;
+    // Plays the side to move on 'index'. Returns false if the cell is off the board or taken.
+    virtual bool play(int index) = 0;
+    // 'X', 'O', ' ' (no result yet) or 'D' (draw); kept up to date by play().
+    virtual char result() const = 0;
+    virtual char toMove() const = 0;
+    // Best move for the side to move within the time budget, or -1 if the game is over.
+    virtual int bestMove(double seconds) = 0;
+    // Positions in 'table' are answered from it; nullptr (or a table of another size) turns that off.
+    virtual void setTablebase(const Tablebase* table) = 0;
+};
+
+template <class Board>
+class BoardSession : public EngineSession {
+public:
+    explicit BoardSession(const Board& empty)
+        : empty(empty), board(empty), player('X'), outcome(' '), tablebase(nullptr) {}
+
+    int cellIndex(int q, int r) const { return board.cellIndex(q, r); }
+    int cellCount() const { return board.cellCount(); }
+    HexCell cellAt(int index) const { return board.cellAt(index); }
+
+    void reset() {
+        board = empty;
+        player = 'X';
+        outcome = ' ';
+    }
+
+    bool play(int index) {
+        if (!board.makeMoveAt(index, player))
+            return false;
+        char winner = board.checkWinnerAt(index);
+        if (winner != ' ')
+            outcome = winner;
+        else if (board.isFull())
+            outcome = 'D';
+        player = (player == 'X') ? 'O' : 'X';
+        return true;
+    }
+
+    char result() const { return outcome; }
+    char toMove() const { return player; }
+
+    int bestMove(double seconds) {
+        if (outcome != ' ')
+            return -1;
+        TablebaseResult stored;
+        if (tablebase && tablebase->probe(board, stored)) {
+            HEX_METRIC_ADD(metrics::tablebaseHits, 1);
+            return stored.bestMove;
+        }
+        // Boards up to the size of the game board are solved exactly, well within any
+        // reasonable budget; larger ones are searched with MCTS for the given time.
+        if (board.cellCount() <= GameBoard::CELL_COUNT) {
+            if (!solver)
+                solver.reset(new HexSolver<Board>(empty, SOLVER_TABLE_MEGABYTES));
+            return solver->solve(board, player).bestMove;
+        }
+        if (!mcts)
+            mcts.reset(new MctsEngine<Board>());
+        return mcts->search(board, player, seconds);
+    }
+
+    void setTablebase(const Tablebase* table) {
+        bool fits = table && table->radius() == board.radius() && table->winLength() == board.winLength();
+        tablebase = fits ? table : nullptr;
+    }
+
+private:
+    Board empty;
+    Board board;
+    char player;
+    char outcome;
+    std::unique_ptr<HexSolver<Board>> solver;   // Created on first use
+    std::unique_ptr<MctsEngine<Board>> mcts;    // Created on first use
+    const Tablebase* tablebase;                 // Owned by main(); only set if it is for this size
+};
+
+std::unique_ptr<EngineSession> newSession(int radius, int k) {
+    return withHexBoard(radius, k, [](const auto& empty) -> std::unique_ptr<EngineSession> {
+        typedef typename std::decay<decltype(empty)>::type Board;
+        return std::unique_ptr<EngineSession>(new BoardSession<Board>(empty));
+    });
+}
+
+// Splits 'line' at spaces and tabs; 'words' is reused between commands.
+void splitWords(const std::string& line, std::vector<std::string>& words) {
+    words.clear();
+    std::size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r'))
+            i++;
+        std::size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r')
+            i++;
+        if (i > start)
+            words.emplace_back(line, start, i - start);
+    }
+}
+
+// Parses "q,r" into a cell index of the session's board; -1 if malformed or off the board.
+int parseCell(const EngineSession& session, const std::string& word) {
+    int q, r;
+    char tail;
+    if (std::sscanf(word.c_str(), "%d,%d%c", &q, &r, &tail) != 2)
+        return -1;
+    return session.cellIndex(q, r);
+}
+
+void appendCell(std::string& out, const EngineSession& session, int index) {
+    HexCell cell = session.cellAt(index);
+    out += std::to_string(cell.q);
+    out += ',';
+    out += std::to_string(cell.r);
+}
+
+// Plays words[first..] as moves. Stops at the first bad one and reports it in 'reply'.
+bool playMoves(EngineSession& session, const std::vector<std::string>& words, std::size_t first, std::string& reply) {
+    for (std::size_t i = first; i < words.size(); i++) {
+        if (session.result() != ' ') {
+            reply = "error game over";
+            return false;
+        }
+        int index = parseCell(session, words[i]);
+        if (index < 0 || !session.play(index)) {
+            reply = "error illegal move " + words[i];
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    int radius = BOARD_RADIUS;
+    int k = WIN_LENGTH;
+    std::unique_ptr<EngineSession> session = newSession(radius, k);
+    std::unique_ptr<EngineSession> scratch = newSession(radius, k);  // Checks "position" move lists
+    Tablebase tablebase;
+
+    std::string line;
+    std::string reply;
+    std::vector<std::string> words;
+    while (std::getline(std::cin, line)) {
+        splitWords(line, words);
+        if (words.empty())
+            continue;
+        const std::string& command = words[0];
+        reply = "ok";
+
+        if (command == "quit") {
+            break;
+        } else if (command == "isready") {
+            reply = "readyok";
+        } else if (command == "metrics") {
+            reply = "metrics " + Metrics::summary();
+        } else if (command == "newgame") {
+            int newRadius = words.size() == 1 ? BOARD_RADIUS : (words.size() == 3 ? std::atoi(words[1].c_str()) : -1);
+            int newK = words.size() == 1 ? WIN_LENGTH : (words.size() == 3 ? std::atoi(words[2].c_str()) : 0);
+            if (newRadius < 0 || newRadius > MAX_BOARD_RADIUS || newK < 1) {
+                reply = "error usage: newgame [radius k]";
+            } else if (newRadius == radius && newK == k) {
+                session->reset();  // Same size: keep the board type and any search state
+            } else {
+                radius = newRadius;
+                k = newK;
+                session = newSession(radius, k);
+                session->setTablebase(tablebase.isOpen() ? &tablebase : nullptr);
+                scratch = newSession(radius, k);
+            }
+        } else if (command == "position") {
+            // The whole list is played on the scratch board first, so a bad move leaves the
+            // current position (and the session's search state) as it was.
+            scratch->reset();
+            if (playMoves(*scratch, words, 1, reply)) {
+                session->reset();
+                playMoves(*session, words, 1, reply);
+            }
+        } else if (command == "play") {
+            if (words.size() != 2)
+                reply = "error usage: play q,r";
+            else
+                playMoves(*session, words, 1, reply);
+        } else if (command == "winner") {
+            char result = session->result();
+            reply = result == ' ' ? "winner none" : (result == 'D' ? "winner draw" : std::string("winner ") + result);
+        } else if (command == "tomove") {
+            reply = session->result() != ' ' ? "tomove none" : std::string("tomove ") + session->toMove();
+        } else if (command == "board") {
+            reply = "board ";
+            for (int i = 0; i < session->cellCount(); i++) {
+                char value = session->cellAt(i).value;
+                reply += value == ' ' ? '.' : value;
+            }
+        } else if (command == "legal") {
+            reply = "legal";
+            for (int i = 0; session->result() == ' ' && i < session->cellCount(); i++) {
+                if (session->cellAt(i).value == ' ') {
+                    reply += ' ';
+                    appendCell(reply, *session, i);
+                }
+            }
+        } else if (command == "go") {
+            double milliseconds = words.size() > 1 ? std::atof(words[1].c_str()) : DEFAULT_MOVE_MILLISECONDS;
+            int move = milliseconds > 0 ? session->bestMove(milliseconds / 1000.0) : -1;
+            if (session->result() != ' ') {
+                reply = "error game over";
+            } else if (move < 0) {
+                reply = "error usage: go [milliseconds]";
+            } else {
+                reply = "bestmove ";
+                appendCell(reply, *session, move);
+            }
+        } else if (command == "tablebase") {
+            std::string error;
+            if (words.size() != 2) {
+                reply = "error usage: tablebase <file>";
+            } else if (!tablebase.open(words[1], error)) {
+                reply = "error " + (error.empty() ? "cannot open " + words[1] : error);
+            }
+            session->setTablebase(tablebase.isOpen() ? &tablebase : nullptr);
+        } else {
+            reply = "error unknown command " + command;
+        }
+
+        std::cout << reply << '\n';
+        if (std::cin.rdbuf()->in_avail() <= 0)
+            std::cout.flush();
+    }
+    std::cout.flush();
+    return 0;
+}
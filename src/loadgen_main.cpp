@@ -0,0 +1,344 @@
+// --- loadgen_main.cpp ---
+// Load generator for hex_server: opens two connections per session, joins them all, and
+// keeps every session playing random games back to back for a fixed time. Each client picks
+// a random empty cell when it is its turn; the time from sending a move to receiving the
+// server's MOVED echo is its round trip. Prints throughput and round-trip percentiles.
+//
+// With --think-ms 0 (the default) every session always has a move in flight, which measures
+// peak throughput; round trips then mostly measure queueing. A think time (randomized to
+// 0.5-1.5x) models players who pause between moves, so many idle sessions can be held open
+// while the round trip of each move is measured.
+//
+//   hex_loadgen [--connect host:port] [--sessions N] [--seconds S] [--think-ms T]
+//               [--radius R --k K] [--seed N]
+#include "HexBoard.h"
+#include "NetProtocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <queue>
+#include <random>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int MAX_EVENTS = 1024;
+const std::size_t READ_CHUNK = 4096;
+
+// Every round trip, in nanoseconds; sorted once for the report.
+class LatencySamples {
+public:
+    LatencySamples() : sorted(true) { samples.reserve(1 << 20); }
+
+    void record(std::int64_t nanos) {
+        samples.push_back(static_cast<std::uint32_t>(std::min<std::int64_t>(nanos, UINT32_MAX)));
+        sorted = false;
+    }
+
+    std::size_t count() const { return samples.size(); }
+
+    // Round trip at percentile p in [0, 1], in microseconds.
+    double percentileMicros(double p) {
+        if (samples.empty())
+            return 0.0;
+        if (!sorted) {
+            std::sort(samples.begin(), samples.end());
+            sorted = true;
+        }
+        return samples[static_cast<std::size_t>(p * (samples.size() - 1))] / 1e3;
+    }
+
+private:
+    std::vector<std::uint32_t> samples;
+    bool sorted;
+};
+
+struct LoadStats {
+    std::uint64_t gamesStarted = 0;
+    std::uint64_t gamesFinished = 0;
+    std::uint64_t gamesAbandoned = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t errors = 0;
+    LatencySamples roundTrips;
+};
+
+std::int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One simulated player. The empty cells are kept in an array with a reverse index, so a
+// random legal move and removing a played cell are both O(1).
+struct Client {
+    int fd = -1;
+    char side = ' ';
+    bool playing = false;
+    int pendingCell = -1;            // Move sent and not yet echoed
+    std::int64_t sentNanos = 0;
+    std::vector<std::uint16_t> emptyCells;
+    std::vector<std::uint16_t> slotOf;  // Index of each cell in emptyCells
+    int emptyCount = 0;
+    std::uint8_t partial[NET_MESSAGE_BYTES];
+    std::size_t partialBytes = 0;
+};
+
+class LoadGenerator {
+public:
+    LoadGenerator(int radius, int k, double thinkMillis, unsigned seed)
+        : radius(radius), k(k), cells(hexCellCount(radius)), thinkNanos(static_cast<std::int64_t>(thinkMillis * 1e6)),
+          rng(seed), epollFd(epoll_create1(0)) {}
+
+    ~LoadGenerator() {
+        for (const Client& client : clients) {
+            if (client.fd >= 0)
+                ::close(client.fd);
+        }
+        ::close(epollFd);
+    }
+
+    bool connectAll(const std::string& host, std::uint16_t port, int count, std::string& error) {
+        clients.resize(count);
+        for (int i = 0; i < count; i++) {
+            NetClient connection;
+            if (!connection.connect(host, port, error)) {
+                error += " (after " + std::to_string(i) + " connections)";
+                return false;
+            }
+            Client& client = clients[i];
+            client.fd = connection.release();
+            client.emptyCells.resize(cells);
+            client.slotOf.resize(cells);
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.u32 = static_cast<std::uint32_t>(i);
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+        }
+        return true;
+    }
+
+    void run(double seconds) {
+        for (std::size_t i = 0; i < clients.size(); i++)
+            join(clients[i]);
+        std::int64_t deadline = nowNanos() + static_cast<std::int64_t>(seconds * 1e9);
+        epoll_event events[MAX_EVENTS];
+        for (std::int64_t now = nowNanos(); now < deadline; now = nowNanos()) {
+            // Play the moves whose think time is over, then sleep until the next one is due.
+            // A game can end while a move is being thought about; its wake-up is then dropped.
+            while (!thinking.empty() && thinking.top().first <= now) {
+                Client& client = clients[thinking.top().second];
+                if (client.playing && client.pendingCell < 0 && isTurnOf(client))
+                    playRandomMove(client);
+                thinking.pop();
+            }
+            std::int64_t wake = thinking.empty() ? deadline : std::min(deadline, thinking.top().first);
+            int timeout = static_cast<int>(std::max<std::int64_t>(0, (wake - now + 999999) / 1000000));
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, timeout);
+            if (count < 0 && errno != EINTR)
+                break;
+            for (int i = 0; i < count; i++)
+                readFrom(events[i].data.u32);
+        }
+    }
+
+    LoadStats& result() { return stats; }
+
+private:
+    void send(Client& client, const NetMessage& message) {
+        std::uint8_t bytes[NET_MESSAGE_BYTES];
+        encodeNetMessage(message, bytes);
+        // Four bytes always fit in an idle socket's send buffer.
+        if (::send(client.fd, bytes, sizeof(bytes), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(bytes)))
+            stats.errors++;
+    }
+
+    void join(Client& client) {
+        client.playing = false;
+        client.pendingCell = -1;
+        send(client, NetMessage{NET_JOIN, static_cast<std::uint8_t>(k), static_cast<std::uint16_t>(radius)});
+    }
+
+    bool isTurnOf(const Client& client) const {
+        return ((cells - client.emptyCount) % 2 == 0) == (client.side == 'X');
+    }
+
+    // Plays now, or after a think time.
+    void takeTurn(std::uint32_t index) {
+        if (thinkNanos <= 0) {
+            playRandomMove(clients[index]);
+            return;
+        }
+        std::uniform_int_distribution<std::int64_t> think(thinkNanos / 2, thinkNanos + thinkNanos / 2);
+        thinking.push(std::make_pair(nowNanos() + think(rng), index));
+    }
+
+    void playRandomMove(Client& client) {
+        std::uniform_int_distribution<int> pick(0, client.emptyCount - 1);
+        client.pendingCell = client.emptyCells[pick(rng)];
+        client.sentNanos = nowNanos();
+        send(client, NetMessage{NET_MOVE, 0, static_cast<std::uint16_t>(client.pendingCell)});
+    }
+
+    void readFrom(std::uint32_t index) {
+        Client& client = clients[index];
+        std::uint8_t data[NET_MESSAGE_BYTES + READ_CHUNK];
+        std::memcpy(data, client.partial, client.partialBytes);
+        ssize_t n = ::recv(client.fd, data + client.partialBytes, READ_CHUNK, 0);
+        if (n <= 0) {
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                std::cerr << "Server closed a connection" << std::endl;
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+                stats.errors++;
+            }
+            return;
+        }
+        std::size_t available = client.partialBytes + n;
+        std::size_t offset = 0;
+        for (; available - offset >= NET_MESSAGE_BYTES; offset += NET_MESSAGE_BYTES)
+            handle(index, decodeNetMessage(data + offset));
+        client.partialBytes = available - offset;
+        std::memcpy(client.partial, data + offset, client.partialBytes);
+    }
+
+    void handle(std::uint32_t index, const NetMessage& message) {
+        Client& client = clients[index];
+        switch (message.type) {
+        case NET_START:
+            client.side = static_cast<char>(message.arg);
+            client.playing = true;
+            client.emptyCount = cells;
+            for (int cell = 0; cell < cells; cell++) {
+                client.emptyCells[cell] = static_cast<std::uint16_t>(cell);
+                client.slotOf[cell] = static_cast<std::uint16_t>(cell);
+            }
+            if (client.side == 'X') {
+                stats.gamesStarted++;
+                takeTurn(index);
+            }
+            break;
+        case NET_MOVED: {
+            int cell = message.value;
+            if (cell == client.pendingCell) {
+                stats.roundTrips.record(nowNanos() - client.sentNanos);
+                stats.moves++;
+                client.pendingCell = -1;
+            }
+            // Swap-remove the cell from the empty list.
+            int slot = client.slotOf[cell];
+            int last = client.emptyCells[--client.emptyCount];
+            client.emptyCells[slot] = static_cast<std::uint16_t>(last);
+            client.slotOf[last] = static_cast<std::uint16_t>(slot);
+            if (message.arg != RESULT_UNFINISHED) {
+                if (client.side == 'X')
+                    stats.gamesFinished++;
+                join(client);
+            } else if (isTurnOf(client)) {
+                takeTurn(index);
+            }
+            break;
+        }
+        case NET_END:
+            stats.gamesAbandoned++;
+            join(client);
+            break;
+        default:
+            stats.errors++;
+            break;
+        }
+    }
+
+    int radius;
+    int k;
+    int cells;
+    std::int64_t thinkNanos;
+    std::mt19937 rng;
+    int epollFd;
+    std::vector<Client> clients;
+    // Clients waiting out their think time: (due time, client index), earliest first.
+    typedef std::pair<std::int64_t, std::uint32_t> Wakeup;
+    std::priority_queue<Wakeup, std::vector<Wakeup>, std::greater<Wakeup>> thinking;
+    LoadStats stats;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string host = "127.0.0.1";
+    std::uint16_t port = HEX_SERVER_PORT;
+    int sessions = 10000;
+    double seconds = 10.0;
+    double thinkMillis = 0.0;
+    int radius = BOARD_RADIUS;
+    int k = WIN_LENGTH;
+    unsigned seed = 1;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        std::string arg = argv[i];
+        if (arg == "--connect" && i + 1 < argc)
+            usage = !parseHostPort(argv[++i], host, port);
+        else if (arg == "--sessions" && i + 1 < argc)
+            sessions = std::atoi(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc)
+            seconds = std::atof(argv[++i]);
+        else if (arg == "--think-ms" && i + 1 < argc)
+            thinkMillis = std::atof(argv[++i]);
+        else if (arg == "--radius" && i + 1 < argc)
+            radius = std::atoi(argv[++i]);
+        else if (arg == "--k" && i + 1 < argc)
+            k = std::atoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else
+            usage = true;
+    }
+    if (usage || sessions < 1 || seconds <= 0 || thinkMillis < 0 || radius < 0 || radius > MAX_BOARD_RADIUS || k < 1 || k > 2 * radius + 1) {
+        std::cerr << "Usage: hex_loadgen [--connect host:port] [--sessions N] [--seconds S] [--think-ms T]\n"
+                     "                   [--radius R --k K] [--seed N]" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    long fileLimit = raiseOpenFileLimit();
+    if (fileLimit >= 0 && 2L * sessions + 16 > fileLimit) {
+        std::cerr << sessions << " sessions need " << 2 * sessions << " connections; the open file limit is "
+                  << fileLimit << " (raise it with ulimit -n)" << std::endl;
+        return 1;
+    }
+
+    LoadGenerator generator(radius, k, thinkMillis, seed);
+    std::string error;
+    auto connectStart = std::chrono::steady_clock::now();
+    if (!generator.connectAll(host, port, 2 * sessions, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    double connectSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - connectStart).count();
+    std::printf("Connected %d clients (%d sessions) to %s:%u in %.2f s, radius %d, %d in a row\n",
+                2 * sessions, sessions, host.c_str(), port, connectSeconds, radius, k);
+    std::fflush(stdout);
+
+    auto start = std::chrono::steady_clock::now();
+    generator.run(seconds);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LoadStats& stats = generator.result();
+    LatencySamples& trips = stats.roundTrips;
+    std::printf("Time: %.2f s  Games: %llu started, %llu finished (%.0f/s), %llu abandoned  Errors: %llu\n",
+                elapsed, static_cast<unsigned long long>(stats.gamesStarted),
+                static_cast<unsigned long long>(stats.gamesFinished), stats.gamesFinished / elapsed,
+                static_cast<unsigned long long>(stats.gamesAbandoned), static_cast<unsigned long long>(stats.errors));
+    std::printf("Moves: %llu (%.0f/s)\n", static_cast<unsigned long long>(stats.moves), stats.moves / elapsed);
+    std::printf("Round trip: p50 %.0f us  p90 %.0f us  p99 %.0f us  p99.9 %.0f us  max %.0f us\n",
+                trips.percentileMicros(0.50), trips.percentileMicros(0.90), trips.percentileMicros(0.99),
+                trips.percentileMicros(0.999), trips.percentileMicros(1.0));
+    return stats.errors == 0 ? 0 : 2;
+}
@@ -1,8 +1,48 @@
 // --- main.cpp ---
+// Trace events go to stdout as text, or to a binary file with --trace <file> (see Trace.h).
+// --connect host[:port] plays against an opponent through hex_server.
 #include "Game.h"
+#include <iostream>
 
-int main() {
-    Game game;
-    game.run();
+int main(int argc, char* argv[]) {
+    std::string tracePath;
+    std::string host;
+    std::uint16_t port = HEX_SERVER_PORT;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (arg == "--connect" && i + 1 < argc)
+            usage = !parseHostPort(argv[++i], host, port);
+        else
+            usage = true;
+    }
+    if (usage) {
+        std::cerr << "Usage: hex_tic_tac_toe [--trace <file>] [--connect host[:port]]" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<TraceSink> sink;
+    if (!tracePath.empty()) {
+        std::unique_ptr<BinaryTraceSink> file(new BinaryTraceSink(tracePath));
+        if (!file->good()) {
+            std::cerr << "Cannot write trace file " << tracePath << std::endl;
+            return 1;
+        }
+        sink = std::move(file);
+    } else {
+        sink.reset(new TextTraceSink(stdout));
+    }
+    Tracer::start(std::move(sink));
+    {
+        Game game;
+        if (!host.empty() && !game.connectRemote(host, port)) {
+            Tracer::stop();
+            return 1;
+        }
+        game.run();
+    }
+    Tracer::stop();
     return 0;
 }
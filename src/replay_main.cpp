@@ -0,0 +1,259 @@
+// --- replay_main.cpp ---
+// Replays binary game archives (see GameRecord.h): every record is re-played on the board
+// engine to check that its moves are legal and its stored result is right, and statistics
+// are gathered per board size: results, average game length, and results by opening cell.
+// Archives are memory-mapped and their blocks shared out between threads.
+//
+//   hex_replay [--threads N] <archive> [archive ...]
+#include "GameRecord.h"
+#include "HexBoard.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+typedef std::array<std::uint64_t, GAME_RESULT_COUNT> ResultCounts;
+
+struct SizeStats {
+    std::uint64_t games = 0;        // Valid records
+    std::uint64_t moves = 0;        // Moves in valid records
+    std::uint64_t invalid = 0;      // Records with an illegal move or a wrong result
+    ResultCounts results = {};
+    std::vector<ResultCounts> openings;  // Results by the cell of the first move
+
+    void merge(const SizeStats& other) {
+        games += other.games;
+        moves += other.moves;
+        invalid += other.invalid;
+        for (int i = 0; i < GAME_RESULT_COUNT; i++)
+            results[i] += other.results[i];
+        if (openings.size() < other.openings.size())
+            openings.resize(other.openings.size(), ResultCounts());
+        for (std::size_t cell = 0; cell < other.openings.size(); cell++) {
+            for (int i = 0; i < GAME_RESULT_COUNT; i++)
+                openings[cell][i] += other.openings[cell][i];
+        }
+    }
+};
+
+// Re-plays records of one board size; the board type is picked once (see withHexBoard).
+class RecordVerifier {
+public:
+    virtual ~RecordVerifier() {}
+    // True if every move is legal and the game ends exactly as the record says.
+    virtual bool verify(const GameRecordView& record) const = 0;
+    virtual int cellCount() const = 0;
+};
+
+template <class Board>
+class BoardVerifier : public RecordVerifier {
+public:
+    explicit BoardVerifier(const Board& empty) : empty(empty) {}
+
+    bool verify(const GameRecordView& record) const {
+        Board board = empty;
+        char player = 'X';
+        GameResult result = RESULT_UNFINISHED;
+        // Neither side can have k in a row before its k-th mark, so the first 2(k - 1)
+        // moves skip the win check.
+        int firstPossibleWin = 2 * (board.winLength() - 1);
+        for (int i = 0; i < record.moveCount; i++) {
+            int cell = record.move(i);
+            if (result != RESULT_UNFINISHED || cell >= board.cellCount() || !board.makeMoveAt(cell, player))
+                return false;
+            char winner = i >= firstPossibleWin ? board.checkWinnerAt(cell) : ' ';
+            result = gameResultFor(winner, board.isFull());
+            player = (player == 'X') ? 'O' : 'X';
+        }
+        return result == record.result;
+    }
+
+    int cellCount() const { return empty.cellCount(); }
+
+private:
+    Board empty;
+};
+
+struct SizeReplay {
+    std::unique_ptr<RecordVerifier> verifier;
+    SizeStats stats;
+};
+
+typedef std::map<std::pair<int, int>, SizeReplay> SizeMap;
+
+struct WorkerResult {
+    SizeMap sizes;
+    std::uint64_t records = 0;
+    std::uint64_t malformedBlocks = 0;
+};
+
+SizeReplay& sizeReplayFor(SizeMap& sizes, int radius, int k) {
+    SizeReplay& entry = sizes[std::make_pair(radius, k)];
+    if (!entry.verifier) {
+        entry.verifier = withHexBoard(radius, k, [](const auto& empty) -> std::unique_ptr<RecordVerifier> {
+            typedef typename std::decay<decltype(empty)>::type Board;
+            return std::unique_ptr<RecordVerifier>(new BoardVerifier<Board>(empty));
+        });
+        entry.stats.openings.assign(entry.verifier->cellCount(), ResultCounts());
+    }
+    return entry;
+}
+
+void replayBlock(const GameBlock& block, WorkerResult& out) {
+    const std::uint8_t* data = block.data;
+    const std::uint8_t* end = block.data + block.bytes;
+    // Most archives hold one board size, so remember the last one instead of a map lookup.
+    SizeReplay* last = nullptr;
+    int lastRadius = -1, lastK = -1;
+    std::uint32_t count = 0;
+    GameRecordView record;
+    while (data < end) {
+        if (!readGameRecord(data, end, record) || record.winLength < 1) {
+            out.malformedBlocks++;
+            return;
+        }
+        count++;
+        if (record.radius != lastRadius || record.winLength != lastK) {
+            last = &sizeReplayFor(out.sizes, record.radius, record.winLength);
+            lastRadius = record.radius;
+            lastK = record.winLength;
+        }
+        SizeStats& stats = last->stats;
+        if (!last->verifier->verify(record)) {
+            stats.invalid++;
+            continue;
+        }
+        stats.games++;
+        stats.moves += record.moveCount;
+        stats.results[record.result]++;
+        if (record.moveCount > 0)
+            stats.openings[record.move(0)][record.result]++;
+    }
+    out.records += count;
+    if (count != block.records)
+        out.malformedBlocks++;
+}
+
+double percent(std::uint64_t part, std::uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+void printSize(int radius, int k, const SizeStats& stats) {
+    std::printf("\nRadius %d, %d in a row: %llu games, %llu invalid, average length %.2f moves\n",
+                radius, k, static_cast<unsigned long long>(stats.games),
+                static_cast<unsigned long long>(stats.invalid),
+                stats.games ? static_cast<double>(stats.moves) / stats.games : 0.0);
+    std::printf("  X wins %.1f%%  O wins %.1f%%  draws %.1f%%  unfinished %.1f%%\n",
+                percent(stats.results[RESULT_X_WINS], stats.games), percent(stats.results[RESULT_O_WINS], stats.games),
+                percent(stats.results[RESULT_DRAW], stats.games), percent(stats.results[RESULT_UNFINISHED], stats.games));
+
+    // Openings, most played first.
+    std::shared_ptr<const HexGeometry> geometry = HexGeometry::get(radius, k);
+    std::vector<std::pair<std::uint64_t, int>> order;
+    for (std::size_t cell = 0; cell < stats.openings.size(); cell++) {
+        const ResultCounts& counts = stats.openings[cell];
+        std::uint64_t games = counts[0] + counts[1] + counts[2] + counts[3];
+        if (games > 0)
+            order.push_back(std::make_pair(games, static_cast<int>(cell)));
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<std::uint64_t, int>& a, const std::pair<std::uint64_t, int>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    std::printf("  %-10s %12s %9s %9s %9s\n", "Opening", "Games", "X wins", "O wins", "Draws");
+    for (const auto &entry : order) {
+        const ResultCounts& counts = stats.openings[entry.second];
+        char cell[32];
+        std::snprintf(cell, sizeof(cell), "%d,%d", geometry->coords[entry.second][0], geometry->coords[entry.second][1]);
+        std::printf("  %-10s %12llu %8.1f%% %8.1f%% %8.1f%%\n", cell, static_cast<unsigned long long>(entry.first),
+                    percent(counts[RESULT_X_WINS], entry.first), percent(counts[RESULT_O_WINS], entry.first),
+                    percent(counts[RESULT_DRAW], entry.first));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    std::vector<std::string> paths;
+    bool usage = argc < 2;
+    for (int i = 1; i < argc && !usage; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            threadCount = std::atoi(argv[++i]);
+        else if (!arg.empty() && arg[0] != '-')
+            paths.push_back(arg);
+        else
+            usage = true;
+    }
+    if (usage || paths.empty()) {
+        std::cerr << "Usage: hex_replay [--threads N] <archive> [archive ...]" << std::endl;
+        return 1;
+    }
+    threadCount = std::max(1, threadCount);
+
+    // Map every archive and pool their blocks.
+    std::vector<std::unique_ptr<GameArchive>> archives;
+    std::vector<GameBlock> blocks;
+    std::size_t totalBytes = 0;
+    for (const auto &path : paths) {
+        std::unique_ptr<GameArchive> archive(new GameArchive());
+        std::string error;
+        if (!archive->open(path, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        if (archive->truncated())
+            std::cerr << path << ": truncated final block ignored" << std::endl;
+        blocks.insert(blocks.end(), archive->blocks().begin(), archive->blocks().end());
+        totalBytes += archive->bytes();
+        archives.push_back(std::move(archive));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> nextBlock(0);
+    std::vector<WorkerResult> results(threadCount);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&, t]() {
+            for (std::size_t i = nextBlock.fetch_add(1); i < blocks.size(); i = nextBlock.fetch_add(1))
+                replayBlock(blocks[i], results[t]);
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    WorkerResult total;
+    for (auto &result : results) {
+        total.records += result.records;
+        total.malformedBlocks += result.malformedBlocks;
+        for (auto &entry : result.sizes)
+            total.sizes[entry.first].stats.merge(entry.second.stats);
+    }
+    std::uint64_t invalid = 0;
+    for (const auto &entry : total.sizes)
+        invalid += entry.second.stats.invalid;
+
+    std::printf("Archives: %zu  Size: %.1f MB  Blocks: %zu  Threads: %d\n",
+                archives.size(), totalBytes / 1e6, blocks.size(), threadCount);
+    std::printf("Records: %llu  Invalid: %llu  Malformed blocks: %llu\n",
+                static_cast<unsigned long long>(total.records), static_cast<unsigned long long>(invalid),
+                static_cast<unsigned long long>(total.malformedBlocks));
+    std::printf("Time: %.3f s  %.1f MB/s  %.0f games/s\n",
+                seconds, seconds > 0 ? totalBytes / 1e6 / seconds : 0.0, seconds > 0 ? total.records / seconds : 0.0);
+    for (const auto &entry : total.sizes)
+        printSize(entry.first.first, entry.first.second, entry.second.stats);
+    return invalid == 0 && total.malformedBlocks == 0 ? 0 : 2;
+}
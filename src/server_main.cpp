@@ -0,0 +1,509 @@
+// --- server_main.cpp ---
+// Headless multiplayer server: hosts any number of concurrent games over TCP with the binary
+// protocol in NetProtocol.h. Clients that JOIN with the same board size are paired in arrival
+// order (the first one plays X), the server keeps the authoritative board, and every accepted
+// move is sent to both players. One thread runs a level-triggered epoll loop. Replies made
+// while handling a batch of events are queued per connection and written once at the end of
+// the batch. Games come from per-size ObjectPools, so a steady stream of games does not
+// allocate.
+//
+//   hex_server [--port N] [--record archive]
+//
+// Runs until interrupted (Ctrl-C or SIGTERM), then prints a summary.
+#include "GameRecord.h"
+#include "HexBoard.h"
+#include "NetProtocol.h"
+#include "ObjectPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const int MAX_EVENTS = 1024;                // Events taken from epoll per wait
+const std::size_t READ_CHUNK = 4096;        // Bytes read per readable connection per batch
+const std::size_t OUTPUT_CAPACITY = 256;    // Bytes a client may leave unread before it is dropped
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+// Every game of one board size; the board type is picked once (see withHexBoard).
+class SessionTable {
+public:
+    virtual ~SessionTable() {}
+    // Starts a game on an empty board and returns its handle.
+    virtual std::uint32_t open() = 0;
+    // 'X' or 'O'.
+    virtual char toMove(std::uint32_t session) const = 0;
+    // Plays the side to move on 'cell' and sets 'result'. Returns false if the move is illegal.
+    virtual bool play(std::uint32_t session, int cell, GameResult& result) = 0;
+    // Appends the game to 'recorder' (if any) and returns the session to the pool.
+    virtual void close(std::uint32_t session, GameRecordWriter* recorder) = 0;
+    virtual std::size_t liveSessions() const = 0;
+    virtual std::size_t peakSessions() const = 0;
+};
+
+template <class Board>
+class BoardSessionTable : public SessionTable {
+public:
+    explicit BoardSessionTable(const Board& empty) : empty(empty) {}
+
+    std::uint32_t open() {
+        std::uint32_t session = pool.acquire(empty);
+        // A recycled session still holds its last game; assigning keeps its storage.
+        pool[session].board = empty;
+        pool[session].moves.clear();
+        return session;
+    }
+
+    char toMove(std::uint32_t session) const { return pool[session].board.moveCount() % 2 == 0 ? 'X' : 'O'; }
+
+    bool play(std::uint32_t session, int cell, GameResult& result) {
+        Session& game = pool[session];
+        if (cell >= game.board.cellCount() || !game.board.makeMoveAt(cell, toMove(session)))
+            return false;
+        game.moves.push_back(cell);
+        result = gameResultFor(game.board.checkWinnerAt(cell), game.board.isFull());
+        return true;
+    }
+
+    void close(std::uint32_t session, GameRecordWriter* recorder) {
+        Session& game = pool[session];
+        if (recorder && !game.moves.empty()) {
+            GameResult result = gameResultFor(game.board.checkWinner(), game.board.isFull());
+            recorder->append(empty.radius(), empty.winLength(), result, game.moves);
+        }
+        pool.release(session);
+    }
+
+    std::size_t liveSessions() const { return pool.size(); }
+    std::size_t peakSessions() const { return pool.capacity(); }
+
+private:
+    struct Session {
+        explicit Session(const Board& empty) : board(empty) {}
+        Board board;
+        std::vector<int> moves;  // For the archive; keeps its capacity across games
+    };
+
+    Board empty;
+    ObjectPool<Session> pool;
+};
+
+// Players of one board size: the table of running games, and the client waiting for an
+// opponent, if any.
+struct SizeEntry {
+    int radius;
+    int k;
+    std::unique_ptr<SessionTable> table;
+    int waiting = -1;
+};
+
+// Per-connection state, indexed by file descriptor. Entries are reused as descriptors are.
+struct Connection {
+    bool open = false;
+    bool queued = false;        // Listed in Server::pendingWrites
+    bool writeBlocked = false;  // Waiting for EPOLLOUT
+    bool overflowed = false;    // Output did not fit; closed at the next flush
+    std::uint8_t partial[NET_MESSAGE_BYTES];
+    std::size_t partialBytes = 0;
+    std::uint8_t output[OUTPUT_CAPACITY];
+    std::size_t outputBytes = 0;
+    SizeEntry* size = nullptr;  // Size joined: waiting for an opponent, or playing
+    bool playing = false;
+    std::uint32_t session = 0;
+    int opponent = -1;
+    char side = ' ';
+};
+
+struct ServerStats {
+    std::uint64_t connections = 0;
+    std::uint64_t gamesStarted = 0;
+    std::uint64_t gamesFinished = 0;
+    std::uint64_t gamesAbandoned = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t slowClients = 0;
+    std::size_t liveConnections = 0;
+    std::size_t peakConnections = 0;
+};
+
+class Server {
+public:
+    explicit Server(GameRecordWriter* recorder) : recorder(recorder), epollFd(-1), listenFd(-1) {}
+    ~Server() {
+        for (std::size_t fd = 0; fd < connections.size(); fd++) {
+            if (connections[fd].open)
+                ::close(static_cast<int>(fd));
+        }
+        if (listenFd >= 0)
+            ::close(listenFd);
+        if (epollFd >= 0)
+            ::close(epollFd);
+    }
+
+    bool listen(std::uint16_t port, std::string& error) {
+        epollFd = epoll_create1(0);
+        listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (epollFd < 0 || listenFd < 0) {
+            error = "cannot create sockets";
+            return false;
+        }
+        int on = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listenFd, SOMAXCONN) != 0) {
+            error = "cannot listen on port " + std::to_string(port) + ": " + std::strerror(errno);
+            return false;
+        }
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = listenFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+        return true;
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        while (!stopRequested) {
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+            if (count < 0 && errno != EINTR) {
+                std::perror("epoll_wait");
+                return;
+            }
+            for (int i = 0; i < count; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll();
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT)
+                    queueWrite(fd);
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                    readFrom(fd);
+            }
+            flushAll();
+        }
+    }
+
+    void printSummary(double seconds) const {
+        std::size_t live = 0, peak = 0;
+        for (const auto &entry : sizes) {
+            live += entry.second.table->liveSessions();
+            peak += entry.second.table->peakSessions();
+        }
+        std::printf("Uptime %.1f s  Connections: %llu total, %zu peak  Sessions: %zu live, %zu peak\n",
+                    seconds, static_cast<unsigned long long>(stats.connections), stats.peakConnections, live, peak);
+        std::printf("Games: %llu started, %llu finished, %llu abandoned  Moves: %llu (%.0f/s)\n",
+                    static_cast<unsigned long long>(stats.gamesStarted), static_cast<unsigned long long>(stats.gamesFinished),
+                    static_cast<unsigned long long>(stats.gamesAbandoned), static_cast<unsigned long long>(stats.moves),
+                    seconds > 0 ? stats.moves / seconds : 0.0);
+        std::printf("Rejected requests: %llu  Slow clients dropped: %llu\n",
+                    static_cast<unsigned long long>(stats.errors), static_cast<unsigned long long>(stats.slowClients));
+    }
+
+private:
+    void acceptAll() {
+        for (;;) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                if (errno == EMFILE || errno == ENFILE)
+                    std::cerr << "Out of file descriptors; connection refused" << std::endl;
+                return;
+            }
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            if (static_cast<std::size_t>(fd) >= connections.size())
+                connections.resize(std::max<std::size_t>(fd + 1, connections.size() * 2));
+            connections[fd] = Connection();
+            connections[fd].open = true;
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+            stats.connections++;
+            stats.liveConnections++;
+            stats.peakConnections = std::max(stats.peakConnections, stats.liveConnections);
+        }
+    }
+
+    void readFrom(int fd) {
+        Connection& connection = connections[fd];
+        if (!connection.open)
+            return;
+        // Any partial message from the previous read goes in front of the new bytes.
+        std::uint8_t data[NET_MESSAGE_BYTES + READ_CHUNK];
+        std::memcpy(data, connection.partial, connection.partialBytes);
+        ssize_t n = ::recv(fd, data + connection.partialBytes, READ_CHUNK, 0);
+        if (n <= 0) {
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                closeConnection(fd);
+            return;
+        }
+        std::size_t available = connection.partialBytes + n;
+        std::size_t offset = 0;
+        for (; available - offset >= NET_MESSAGE_BYTES && connection.open; offset += NET_MESSAGE_BYTES)
+            handle(fd, decodeNetMessage(data + offset));
+        if (!connection.open)
+            return;
+        connection.partialBytes = available - offset;
+        std::memcpy(connection.partial, data + offset, connection.partialBytes);
+    }
+
+    void handle(int fd, const NetMessage& message) {
+        if (message.type == NET_JOIN)
+            join(fd, message.value, message.arg);
+        else if (message.type == NET_MOVE)
+            move(fd, message.value);
+        else
+            reject(fd, NET_ERROR_BAD_MESSAGE);
+    }
+
+    void join(int fd, int radius, int k) {
+        leave(fd);
+        if (radius > MAX_BOARD_RADIUS || k < 1 || k > 2 * radius + 1) {
+            reject(fd, NET_ERROR_BAD_SIZE);
+            return;
+        }
+        SizeEntry& entry = sizes[std::make_pair(radius, k)];
+        if (!entry.table) {
+            entry.radius = radius;
+            entry.k = k;
+            entry.table = withHexBoard(radius, k, [](const auto& empty) -> std::unique_ptr<SessionTable> {
+                typedef typename std::decay<decltype(empty)>::type Board;
+                return std::unique_ptr<SessionTable>(new BoardSessionTable<Board>(empty));
+            });
+        }
+        Connection& connection = connections[fd];
+        connection.size = &entry;
+        if (entry.waiting < 0) {
+            entry.waiting = fd;
+            return;
+        }
+        // Pair with the client that has waited; it joined first, so it plays X.
+        int xFd = entry.waiting;
+        entry.waiting = -1;
+        std::uint32_t session = entry.table->open();
+        Connection& x = connections[xFd];
+        x.playing = connection.playing = true;
+        x.session = connection.session = session;
+        x.opponent = fd;
+        connection.opponent = xFd;
+        x.side = 'X';
+        connection.side = 'O';
+        stats.gamesStarted++;
+        send(xFd, NetMessage{NET_START, 'X', 0});
+        send(fd, NetMessage{NET_START, 'O', 0});
+    }
+
+    void move(int fd, int cell) {
+        Connection& connection = connections[fd];
+        if (!connection.playing) {
+            reject(fd, NET_ERROR_NOT_IN_GAME);
+            return;
+        }
+        SessionTable& table = *connection.size->table;
+        if (table.toMove(connection.session) != connection.side) {
+            reject(fd, NET_ERROR_NOT_YOUR_TURN);
+            return;
+        }
+        GameResult result;
+        if (!table.play(connection.session, cell, result)) {
+            reject(fd, NET_ERROR_ILLEGAL_MOVE);
+            return;
+        }
+        stats.moves++;
+        int opponent = connection.opponent;
+        NetMessage moved{NET_MOVED, result, static_cast<std::uint16_t>(cell)};
+        send(fd, moved);
+        send(opponent, moved);
+        if (result != RESULT_UNFINISHED) {
+            stats.gamesFinished++;
+            endGame(fd);
+        }
+    }
+
+    // Returns both players of the connection's game to the lobby and frees the session.
+    void endGame(int fd) {
+        Connection& connection = connections[fd];
+        Connection& opponent = connections[connection.opponent];
+        connection.size->table->close(connection.session, recorder);
+        opponent.playing = connection.playing = false;
+        opponent.size = connection.size = nullptr;
+        opponent.opponent = connection.opponent = -1;
+    }
+
+    // Takes the connection out of the waiting slot, or forfeits its game.
+    void leave(int fd) {
+        Connection& connection = connections[fd];
+        if (connection.playing) {
+            send(connection.opponent, NetMessage{NET_END, NET_END_OPPONENT_LEFT, 0});
+            stats.gamesAbandoned++;
+            endGame(fd);
+        } else if (connection.size) {
+            if (connection.size->waiting == fd)
+                connection.size->waiting = -1;
+            connection.size = nullptr;
+        }
+    }
+
+    void reject(int fd, NetError error) {
+        stats.errors++;
+        send(fd, NetMessage{NET_ERROR, error, 0});
+    }
+
+    void send(int fd, const NetMessage& message) {
+        Connection& connection = connections[fd];
+        if (!connection.open)
+            return;
+        if (connection.outputBytes + NET_MESSAGE_BYTES > OUTPUT_CAPACITY) {
+            // The client has stopped reading; it is closed at the next flush.
+            connection.overflowed = true;
+        } else {
+            encodeNetMessage(message, connection.output + connection.outputBytes);
+            connection.outputBytes += NET_MESSAGE_BYTES;
+        }
+        queueWrite(fd);
+    }
+
+    void queueWrite(int fd) {
+        Connection& connection = connections[fd];
+        if (connection.open && !connection.queued) {
+            connection.queued = true;
+            pendingWrites.push_back(fd);
+        }
+    }
+
+    // Writes every queued output buffer. Closing a connection here can queue a message to its
+    // opponent, so the list may grow while it is walked.
+    void flushAll() {
+        for (std::size_t i = 0; i < pendingWrites.size(); i++) {
+            int fd = pendingWrites[i];
+            Connection& connection = connections[fd];
+            connection.queued = false;
+            if (!connection.open)
+                continue;
+            if (connection.overflowed) {
+                stats.slowClients++;
+                closeConnection(fd);
+                continue;
+            }
+            std::size_t written = 0;
+            while (written < connection.outputBytes) {
+                ssize_t n = ::send(fd, connection.output + written, connection.outputBytes - written, MSG_NOSIGNAL);
+                if (n > 0)
+                    written += n;
+                else if (n < 0 && errno == EINTR)
+                    continue;
+                else
+                    break;
+            }
+            if (written < connection.outputBytes && errno != EAGAIN && errno != EWOULDBLOCK) {
+                closeConnection(fd);
+                continue;
+            }
+            std::memmove(connection.output, connection.output + written, connection.outputBytes - written);
+            connection.outputBytes -= written;
+            // Watch for writability only while output is stuck in the buffer.
+            bool blocked = connection.outputBytes > 0;
+            if (blocked != connection.writeBlocked) {
+                connection.writeBlocked = blocked;
+                epoll_event event;
+                event.events = blocked ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+                event.data.fd = fd;
+                epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+            }
+        }
+        pendingWrites.clear();
+    }
+
+    void closeConnection(int fd) {
+        leave(fd);
+        connections[fd].open = false;
+        ::close(fd);  // Also removes it from the epoll set
+        stats.liveConnections--;
+    }
+
+    GameRecordWriter* recorder;
+    int epollFd;
+    int listenFd;
+    std::vector<Connection> connections;
+    std::vector<int> pendingWrites;
+    std::map<std::pair<int, int>, SizeEntry> sizes;
+    ServerStats stats;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::uint16_t port = HEX_SERVER_PORT;
+    std::string recordPath;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            int value = std::atoi(argv[++i]);
+            usage = value < 1 || value > 65535;
+            port = static_cast<std::uint16_t>(value);
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else {
+            usage = true;
+        }
+    }
+    if (usage) {
+        std::cerr << "Usage: hex_server [--port N] [--record archive]" << std::endl;
+        return 1;
+    }
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;  // No SA_RESTART: epoll_wait returns with EINTR
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+    long fileLimit = raiseOpenFileLimit();
+
+    std::unique_ptr<GameRecordWriter> recorder;
+    if (!recordPath.empty())
+        recorder.reset(new GameRecordWriter(recordPath));
+    Server server(recorder.get());
+    std::string error;
+    if (!server.listen(port, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::printf("hex_server listening on port %u (up to %ld open files)\n", port, fileLimit);
+    std::fflush(stdout);
+
+    auto start = std::chrono::steady_clock::now();
+    server.run();
+    server.printSummary(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    if (recorder && !recorder->flush())
+        std::cerr << "Failed to write " << recordPath << std::endl;
+    return 0;
+}
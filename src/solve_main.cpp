@@ -0,0 +1,36 @@
+// --- solve_main.cpp ---
+// Command-line front end for HexSolver: solves the game board after an optional list of
+// moves ("q,r" pairs, played alternately starting with X) and reports the search rate.
+#include "HexBoard.h"
+#include "HexSolver.h"
+#include <cstdio>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    GameBoard board;
+    char player = 'X';
+    for (int i = 1; i < argc; i++) {
+        int q, r;
+        if (std::sscanf(argv[i], "%d,%d", &q, &r) != 2 || !board.makeMove(q, r, player)) {
+            std::cerr << "Invalid move: " << argv[i] << std::endl;
+            return 1;
+        }
+        player = (player == 'X') ? 'O' : 'X';
+    }
+
+    HexSolver<GameBoard> solver(board);
+    SolveResult result = solver.solve(board, player);
+
+    std::cout << "To move: " << player << "\n";
+    if (result.winner == ' ')
+        std::cout << "Value: draw\n";
+    else
+        std::cout << "Value: " << result.winner << " wins in " << result.pliesToEnd << " plies\n";
+    if (result.bestMove >= 0) {
+        HexCell best = board.cellAt(result.bestMove);
+        std::cout << "Best move: " << best.q << "," << best.r << "\n";
+    }
+    std::printf("Nodes: %llu  Time: %.3f s  Nodes/sec: %.0f\n",
+                static_cast<unsigned long long>(result.nodes), result.seconds, result.nodesPerSecond());
+    return 0;
+}
@@ -0,0 +1,366 @@
+// --- tablebase_main.cpp ---
+// Builds a tablebase (see Tablebase.h). Every reachable position is enumerated ply by ply,
+// one layer of canonical positions at a time, on a work-stealing thread pool:
+//
+//   - Forward: each worker expands its share of layer n into its own buffer; the buffers
+//     are merged, sorted by key and de-duplicated into layer n + 1. Finished games are not
+//     stored; their value is known from the move that ends them.
+//   - Backward (complete tables): layer n is valued from layer n + 1, from the last layer
+//     back to the empty board, with win, loss or draw and the plies to that result.
+//
+// Boards small enough to enumerate completely (the 19-cell game board) get a complete table;
+// larger boards get a partial one covering the first --depth plies, where positions are
+// scored with a short MCTS search instead (an immediate win is still stored as exact). The
+// written file is mapped again at the end and every position looked up to check it.
+//
+//   hex_tablebase [--radius R] [--k K] [--depth N] [--seconds S] [--threads N] [--output FILE]
+#include "HexBoard.h"
+#include "MctsEngine.h"
+#include "Tablebase.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+const int COMPLETE_MAX_CELLS = 19;              // Larger boards get a partial table by default
+const int DEFAULT_PARTIAL_DEPTH = 2;            // Plies covered by a default partial table
+const double DEFAULT_ESTIMATE_SECONDS = 0.25;   // MCTS time per position in a partial table
+const std::size_t EXPAND_GRAIN = 256;           // Positions per task when expanding or valuing a layer
+const std::size_t ESTIMATE_MCTS_NODES = 1 << 18;
+const std::size_t VERIFY_PROBES = 100000;       // Board lookups timed after writing
+
+struct Options {
+    int radius = BOARD_RADIUS;
+    int k = WIN_LENGTH;
+    int depth = -1;                         // -1: complete if the board is small enough
+    double seconds = DEFAULT_ESTIMATE_SECONDS;
+    int threads = 0;
+    std::string output = TABLEBASE_DEFAULT_PATH;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Orders exact values for the side to move: quicker wins first, then draws, then slower losses.
+int rankOf(const TablebaseEntry& entry) {
+    if (entry.value == TB_WIN)
+        return 1000 - entry.detail;
+    if (entry.value == TB_LOSS)
+        return -1000 + entry.detail;
+    return 0;
+}
+
+// A child's value, seen by the player who moved into it.
+TablebaseEntry parentView(const TablebaseEntry& child) {
+    TablebaseEntry entry = child;
+    if (child.value == TB_WIN)
+        entry.value = TB_LOSS;
+    else if (child.value == TB_LOSS)
+        entry.value = TB_WIN;
+    entry.detail = static_cast<std::uint8_t>(std::min(255, child.detail + 1));
+    return entry;
+}
+
+template <class Board>
+struct Position {
+    std::uint64_t key;
+    Board board;  // Whichever symmetric image was reached first; moves are mapped to the canonical frame
+};
+
+template <class Board>
+class TablebaseBuilder {
+public:
+    TablebaseBuilder(const Board& empty, const Options& options, WorkStealingPool& pool)
+        : empty(empty), options(options), pool(pool), hasher(empty, TABLEBASE_KEY_SEED) {}
+
+    int run() {
+        int cells = empty.cellCount();
+        int depth = options.depth >= 0 ? std::min(options.depth, cells) : (cells <= COMPLETE_MAX_CELLS ? cells : DEFAULT_PARTIAL_DEPTH);
+        bool complete = depth == cells;
+        std::printf("Board: radius %d, %d in a row, %d cells  Table: %s, %d plies  Threads: %d\n",
+                    options.radius, options.k, cells, complete ? "complete" : "partial", depth, pool.size());
+
+        auto start = std::chrono::steady_clock::now();
+        layers.clear();
+        layers.emplace_back(1, Position<Board>{0, empty});
+        for (int n = 0; n + 1 < depth && !layers.back().empty(); n++) {
+            auto layerStart = std::chrono::steady_clock::now();
+            expand(n);
+            std::printf("  ply %2d: %10zu positions  %.2f s\n", n + 1, layers.back().size(), secondsSince(layerStart));
+            std::fflush(stdout);
+        }
+        std::size_t total = 0;
+        for (const auto &layer : layers)
+            total += layer.size();
+        std::printf("Enumerated %zu positions in %.2f s\n", total, secondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        values.assign(layers.size(), std::vector<TablebaseEntry>());
+        for (std::size_t n = layers.size(); n-- > 0;)
+            evaluate(n, complete);
+        std::printf("Valued %zu positions in %.2f s (%s)  Tasks stolen: %llu\n", total, secondsSince(start),
+                    complete ? "retrograde" : "MCTS estimates", static_cast<unsigned long long>(pool.steals()));
+        TablebaseResult root = Tablebase::resultFor(values[0][0], 0);
+        std::printf("Empty board: %s\n", describeTablebaseResult(root, 'X').c_str());
+
+        start = std::chrono::steady_clock::now();
+        std::vector<TablebaseRecord> records;
+        records.reserve(total);
+        for (std::size_t n = 0; n < layers.size(); n++) {
+            for (std::size_t i = 0; i < layers[n].size(); i++)
+                records.push_back(TablebaseRecord{layers[n][i].key, values[n][i]});
+        }
+        std::string error;
+        if (!writeTablebase(options.output, options.radius, options.k, depth, complete, records, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        records.clear();
+        records.shrink_to_fit();
+        std::printf("Wrote %s in %.2f s\n", options.output.c_str(), secondsSince(start));
+        return verify() ? 0 : 2;
+    }
+
+private:
+    static char playerFor(std::size_t marks) { return marks % 2 == 0 ? 'X' : 'O'; }
+
+    // Builds layer n + 1 from layer n.
+    void expand(std::size_t n) {
+        const std::vector<Position<Board>>& layer = layers[n];
+        char player = playerFor(n);
+        std::vector<std::vector<Position<Board>>> found(pool.size());
+        pool.parallelFor(layer.size(), EXPAND_GRAIN, [&](std::size_t begin, std::size_t end, int worker) {
+            std::vector<Position<Board>>& out = found[worker];
+            TablebaseHasher::Hashes hashes;
+            for (std::size_t i = begin; i < end; i++) {
+                const Board& board = layer[i].board;
+                hasher.hash(board, hashes);
+                for (int cell = 0; cell < board.cellCount(); cell++) {
+                    if (board.valueAt(cell) != ' ')
+                        continue;
+                    Board next = board;
+                    next.makeMoveAt(cell, player);
+                    if (next.checkWinnerAt(cell) != ' ' || next.isFull())
+                        continue;
+                    TablebaseHasher::Hashes nextHashes = hashes;
+                    hasher.toggle(nextHashes, cell, player);
+                    out.push_back(Position<Board>{nextHashes[TablebaseHasher::canonicalSymmetry(nextHashes)], next});
+                }
+            }
+        });
+
+        std::vector<Position<Board>> next;
+        std::size_t count = 0;
+        for (const auto &buffer : found)
+            count += buffer.size();
+        next.reserve(count);
+        for (auto &buffer : found) {
+            next.insert(next.end(), buffer.begin(), buffer.end());
+            std::vector<Position<Board>>().swap(buffer);
+        }
+        auto byKey = [](const Position<Board>& a, const Position<Board>& b) { return a.key < b.key; };
+        std::sort(next.begin(), next.end(), byKey);
+        next.erase(std::unique(next.begin(), next.end(),
+                               [](const Position<Board>& a, const Position<Board>& b) { return a.key == b.key; }),
+                   next.end());
+        next.shrink_to_fit();
+        layers.push_back(std::move(next));
+    }
+
+    // Values layer n: exactly from layer n + 1 in a complete table, else by estimate.
+    void evaluate(std::size_t n, bool exact) {
+        const std::vector<Position<Board>>& layer = layers[n];
+        std::vector<TablebaseEntry>& out = values[n];
+        out.resize(layer.size());
+        if (!exact && estimators.empty()) {
+            for (int i = 0; i < pool.size(); i++)
+                estimators.emplace_back(new MctsEngine<Board>(ESTIMATE_MCTS_NODES, 1));
+        }
+        char player = playerFor(n);
+        // Estimates cost a search each, so they are handed out one position at a time.
+        pool.parallelFor(layer.size(), exact ? EXPAND_GRAIN : 1, [&](std::size_t begin, std::size_t end, int worker) {
+            TablebaseHasher::Hashes hashes;
+            for (std::size_t i = begin; i < end; i++) {
+                const Board& board = layer[i].board;
+                hasher.hash(board, hashes);
+                int symmetry = TablebaseHasher::canonicalSymmetry(hashes);
+                int bestCell = -1;
+                TablebaseEntry best = valueOf(board, player, hashes, n, exact, bestCell);
+                if (!exact && best.value != TB_WIN) {
+                    MctsEngine<Board>& mcts = *estimators[worker];
+                    bestCell = mcts.search(board, player, options.seconds);
+                    best.value = TB_ESTIMATE;
+                    best.detail = static_cast<std::uint8_t>(std::lround(mcts.stats().value * 255));
+                }
+                best.check = 0;
+                best.move = static_cast<std::uint16_t>(hasher.symmetry().map(symmetry, bestCell));
+                out[i] = best;
+            }
+        });
+    }
+
+    // Best of the moves from 'board': a win on the spot, or (exact) the best child value.
+    TablebaseEntry valueOf(const Board& board, char player, const TablebaseHasher::Hashes& hashes, std::size_t n,
+                           bool exact, int& bestCell) const {
+        TablebaseEntry best = TablebaseEntry{0, 0, TB_LOSS, 0};
+        int bestRank = -2000;
+        for (int cell = 0; cell < board.cellCount(); cell++) {
+            if (board.valueAt(cell) != ' ')
+                continue;
+            Board next = board;
+            next.makeMoveAt(cell, player);
+            TablebaseEntry entry;
+            if (next.checkWinnerAt(cell) == player) {
+                bestCell = cell;
+                return TablebaseEntry{0, 0, TB_WIN, 1};
+            } else if (!exact) {
+                if (bestCell < 0)
+                    bestCell = cell;
+                continue;
+            } else if (next.isFull()) {
+                entry = TablebaseEntry{0, 0, TB_DRAW, 1};
+            } else {
+                TablebaseHasher::Hashes nextHashes = hashes;
+                hasher.toggle(nextHashes, cell, player);
+                entry = parentView(childValue(n + 1, nextHashes[TablebaseHasher::canonicalSymmetry(nextHashes)]));
+            }
+            int rank = rankOf(entry);
+            if (rank > bestRank) {
+                bestRank = rank;
+                best = entry;
+                bestCell = cell;
+            }
+        }
+        return best;
+    }
+
+    const TablebaseEntry& childValue(std::size_t n, std::uint64_t key) const {
+        const std::vector<Position<Board>>& layer = layers[n];
+        auto it = std::lower_bound(layer.begin(), layer.end(), key,
+                                   [](const Position<Board>& p, std::uint64_t k) { return p.key < k; });
+        return values[n][it - layer.begin()];
+    }
+
+    // Maps the written file and looks every position up by key (and a sample through probe()).
+    bool verify() {
+        auto start = std::chrono::steady_clock::now();
+        Tablebase table;
+        std::string error;
+        if (!table.open(options.output, error)) {
+            std::cerr << (error.empty() ? "cannot open " + options.output : error) << std::endl;
+            return false;
+        }
+        double openSeconds = secondsSince(start);
+
+        std::size_t total = 0, wrong = 0;
+        start = std::chrono::steady_clock::now();
+        for (std::size_t n = 0; n < layers.size(); n++) {
+            for (std::size_t i = 0; i < layers[n].size(); i++) {
+                const TablebaseEntry* entry = table.find(layers[n][i].key);
+                const TablebaseEntry& expected = values[n][i];
+                if (!entry || entry->value != expected.value || entry->detail != expected.detail || entry->move != expected.move)
+                    wrong++;
+                total++;
+            }
+        }
+        double findSeconds = secondsSince(start);
+
+        // Whole-board probes (hashing included) of positions from random play, collected first
+        // so only the lookups are timed. The answers must be legal moves.
+        std::vector<Board> boards;
+        std::uint64_t rng = 0x9E3779B97F4A7C15ULL;
+        while (boards.size() < VERIFY_PROBES) {
+            Board board = empty;
+            char player = 'X';
+            while (!board.isFull() && board.moveCount() < table.depth() && boards.size() < VERIFY_PROBES) {
+                boards.push_back(board);
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                int cell = static_cast<int>(rng % board.cellCount());
+                while (board.valueAt(cell) != ' ')
+                    cell = (cell + 1) % board.cellCount();
+                board.makeMoveAt(cell, player);
+                if (board.checkWinnerAt(cell) != ' ')
+                    break;
+                player = player == 'X' ? 'O' : 'X';
+            }
+        }
+        std::size_t probes = boards.size(), hits = 0;
+        std::vector<int> moves(probes, -1);
+        start = std::chrono::steady_clock::now();
+        TablebaseResult result;
+        for (std::size_t i = 0; i < probes; i++) {
+            if (table.probe(boards[i], result)) {
+                hits++;
+                moves[i] = result.bestMove;
+            }
+        }
+        double probeSeconds = secondsSince(start);
+        for (std::size_t i = 0; i < probes; i++) {
+            if (moves[i] >= 0 && (moves[i] >= boards[i].cellCount() || boards[i].valueAt(moves[i]) != ' '))
+                wrong++;
+        }
+
+        std::printf("Verify: %zu entries, %zu wrong  File: %.1f MB  Open: %.1f us\n",
+                    total, wrong, table.bytes() / 1e6, openSeconds * 1e6);
+        std::printf("  find (by key): %.1f ns  probe (board): %.1f ns, %zu of %zu positions found\n",
+                    total ? findSeconds * 1e9 / total : 0.0, probes ? probeSeconds * 1e9 / probes : 0.0, hits, probes);
+        return wrong == 0;
+    }
+
+    Board empty;
+    const Options& options;
+    WorkStealingPool& pool;
+    TablebaseHasher hasher;
+    std::vector<std::vector<Position<Board>>> layers;   // layers[n]: positions with n marks, sorted by key
+    std::vector<std::vector<TablebaseEntry>> values;    // values[n][i] for layers[n][i]
+    std::vector<std::unique_ptr<MctsEngine<Board>>> estimators;  // One per worker (partial tables)
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        std::string arg = argv[i];
+        if (arg == "--radius" && i + 1 < argc)
+            options.radius = std::atoi(argv[++i]);
+        else if (arg == "--k" && i + 1 < argc)
+            options.k = std::atoi(argv[++i]);
+        else if (arg == "--depth" && i + 1 < argc)
+            options.depth = std::atoi(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc)
+            options.seconds = std::atof(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            options.threads = std::atoi(argv[++i]);
+        else if (arg == "--output" && i + 1 < argc)
+            options.output = argv[++i];
+        else
+            usage = true;
+    }
+    if (usage || options.radius < 0 || options.radius > MAX_BOARD_RADIUS || options.k < 1 || options.depth == 0 ||
+        options.seconds <= 0) {
+        std::cerr << "Usage: hex_tablebase [--radius R] [--k K] [--depth N] [--seconds S] [--threads N] [--output FILE]"
+                  << std::endl;
+        return 1;
+    }
+
+    WorkStealingPool pool(options.threads);
+    return withHexBoard(options.radius, options.k, [&](const auto& empty) {
+        typedef typename std::decay<decltype(empty)>::type Board;
+        TablebaseBuilder<Board> builder(empty, options, pool);
+        return builder.run();
+    });
+}
@@ -0,0 +1,595 @@
+// --- tournament_main.cpp ---
+// Plays engines against each other on the HexBoard rules and rates them. Every pair of
+// engines plays --games games. Each game starts with --opening uniformly random plies, and
+// every opening is played twice with the colours swapped, so the deterministic engines see
+// varied positions and neither side of a pairing profits from a lucky opening or from
+// moving first.
+//
+// Games are spread over a work-stealing thread pool. Each worker owns its board, its engines
+// (one AlphaBetaSearch, one single-threaded MctsEngine), its RNG, and its result tallies and
+// move-time histograms; nothing is shared while games run, and the tallies are merged at the
+// end. A game's RNG is seeded from --seed and the opening's number, so results do not depend
+// on which worker played it.
+//
+// Engines:
+//   random        a uniformly random empty cell
+//   greedy        the best move by the static evaluation after one ply (AlphaBetaSearch, depth 1)
+//   alphabeta:N   AlphaBetaSearch, N plies deep
+//   mcts:S        MctsEngine on one thread, S seconds per move
+//
+// Ratings are the Bradley-Terry maximum-likelihood fit to every game (a draw is half a win
+// for each side), relative to the first engine, with 95% intervals from the fit's
+// covariance. One virtual draw per pairing keeps the ratings finite when an engine never
+// scores. The pairing table also gives each head-to-head result as an Elo difference.
+//
+//   hex_tournament [--engine SPEC]... [--games N] [--radius R] [--k K] [--opening N]
+//                  [--threads N] [--seed S]
+#include "AlphaBetaSearch.h"
+#include "HexBoard.h"
+#include "HexSolver.h"
+#include "MctsEngine.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+const char* const DEFAULT_ENGINES[] = {"random", "greedy", "alphabeta:2", "alphabeta:4", "mcts:0.01"};
+const int DEFAULT_GAMES = 100;             // Per pairing
+const int DEFAULT_OPENING_PLIES = 2;
+const std::size_t GAME_GRAIN = 4;          // Games per task
+const std::size_t MCTS_NODES = 1 << 18;    // Arena per worker
+const double Z_95 = 1.959964;              // Two-sided 95% normal quantile
+const double ELO_PER_NATURAL = 400.0 / std::log(10.0);
+
+enum EngineKind {
+    ENGINE_RANDOM,
+    ENGINE_GREEDY,
+    ENGINE_ALPHABETA,
+    ENGINE_MCTS
+};
+
+struct EngineSpec {
+    std::string name;
+    EngineKind kind;
+    int depth;
+    double seconds;
+};
+
+struct Options {
+    std::vector<EngineSpec> engines;
+    int games = DEFAULT_GAMES;
+    int radius = BOARD_RADIUS;
+    int k = WIN_LENGTH;
+    int opening = DEFAULT_OPENING_PLIES;
+    int threads = 0;
+    std::uint64_t seed = 1;
+};
+
+bool parseEngine(const std::string& text, EngineSpec& spec) {
+    spec.name = text;
+    spec.depth = 0;
+    spec.seconds = 0;
+    std::size_t colon = text.find(':');
+    std::string kind = text.substr(0, colon);
+    std::string argument = colon == std::string::npos ? "" : text.substr(colon + 1);
+    if (kind == "random" && argument.empty()) {
+        spec.kind = ENGINE_RANDOM;
+    } else if (kind == "greedy" && argument.empty()) {
+        spec.kind = ENGINE_GREEDY;
+        spec.depth = 1;
+    } else if (kind == "alphabeta" && !argument.empty()) {
+        spec.kind = ENGINE_ALPHABETA;
+        spec.depth = std::atoi(argument.c_str());
+        return spec.depth >= 1;
+    } else if (kind == "mcts" && !argument.empty()) {
+        spec.kind = ENGINE_MCTS;
+        spec.seconds = std::atof(argument.c_str());
+        return spec.seconds > 0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Move times in log-linear buckets: exact below 8 ns, then 8 buckets per power of two
+// (12.5% resolution), so per-worker histograms are small and merge by addition.
+class MoveTimes {
+public:
+    static const int SUB_BUCKETS = 8;
+    static const int BUCKET_COUNT = 44 * SUB_BUCKETS;  // Up to 2^46 ns
+
+    MoveTimes() : counts(BUCKET_COUNT, 0), total(0), totalNanos(0), maxNanos(0) {}
+
+    void add(std::uint64_t nanos) {
+        counts[std::min(bucketOf(nanos), BUCKET_COUNT - 1)]++;
+        total++;
+        totalNanos += nanos;
+        maxNanos = std::max(maxNanos, nanos);
+    }
+    void merge(const MoveTimes& other) {
+        for (int i = 0; i < BUCKET_COUNT; i++)
+            counts[i] += other.counts[i];
+        total += other.total;
+        totalNanos += other.totalNanos;
+        maxNanos = std::max(maxNanos, other.maxNanos);
+    }
+
+    std::uint64_t count() const { return total; }
+    double meanNanos() const { return total ? static_cast<double>(totalNanos) / total : 0.0; }
+    std::uint64_t maximum() const { return maxNanos; }
+    // Upper edge of the bucket holding percentile p in [0, 1].
+    double percentile(double p) const {
+        if (total == 0)
+            return 0.0;
+        std::uint64_t target = static_cast<std::uint64_t>(p * (total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            seen += counts[i];
+            if (seen >= target)
+                return static_cast<double>(std::min(lowerEdge(i + 1), maxNanos));
+        }
+        return static_cast<double>(maxNanos);
+    }
+
+private:
+    static int bucketOf(std::uint64_t nanos) {
+        if (nanos < SUB_BUCKETS)
+            return static_cast<int>(nanos);
+        int exponent = 63 - __builtin_clzll(nanos);  // >= 3
+        int mantissa = static_cast<int>((nanos >> (exponent - 3)) & (SUB_BUCKETS - 1));
+        return (exponent - 2) * SUB_BUCKETS + mantissa;
+    }
+    static std::uint64_t lowerEdge(int bucket) {
+        if (bucket < SUB_BUCKETS)
+            return static_cast<std::uint64_t>(bucket);
+        int exponent = bucket / SUB_BUCKETS + 2;
+        return static_cast<std::uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 3);
+    }
+
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total;
+    std::uint64_t totalNanos;
+    std::uint64_t maxNanos;
+};
+
+std::string formatNanos(double nanos) {
+    char buffer[32];
+    if (nanos < 1e3)
+        std::snprintf(buffer, sizeof(buffer), "%.0f ns", nanos);
+    else if (nanos < 1e6)
+        std::snprintf(buffer, sizeof(buffer), "%.1f us", nanos / 1e3);
+    else if (nanos < 1e9)
+        std::snprintf(buffer, sizeof(buffer), "%.1f ms", nanos / 1e6);
+    else
+        std::snprintf(buffer, sizeof(buffer), "%.2f s", nanos / 1e9);
+    return buffer;
+}
+
+// Results of one pairing, from its first engine's side.
+struct PairResult {
+    std::uint64_t wins = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t losses = 0;
+
+    std::uint64_t games() const { return wins + draws + losses; }
+    double score() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+};
+
+struct Pairing {
+    int first;
+    int second;
+};
+
+double eloFromScore(double score) {
+    if (score <= 0.0)
+        return -INFINITY;
+    if (score >= 1.0)
+        return INFINITY;
+    return -ELO_PER_NATURAL * std::log(1.0 / score - 1.0);
+}
+
+std::string formatElo(double elo) {
+    char buffer[16];
+    if (std::isinf(elo))
+        return elo > 0 ? "+inf" : "-inf";
+    std::snprintf(buffer, sizeof(buffer), "%+.0f", std::round(elo) + 0.0);  // No "-0"
+    return buffer;
+}
+
+// Inverts a small symmetric positive-definite matrix in place (Gauss-Jordan). Returns false
+// if it is singular.
+bool invert(std::vector<std::vector<double>>& m) {
+    int n = static_cast<int>(m.size());
+    std::vector<std::vector<double>> inverse(n, std::vector<double>(n, 0.0));
+    for (int i = 0; i < n; i++)
+        inverse[i][i] = 1.0;
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++) {
+            if (std::fabs(m[row][col]) > std::fabs(m[pivot][col]))
+                pivot = row;
+        }
+        if (std::fabs(m[pivot][col]) < 1e-12)
+            return false;
+        std::swap(m[pivot], m[col]);
+        std::swap(inverse[pivot], inverse[col]);
+        double scale = 1.0 / m[col][col];
+        for (int j = 0; j < n; j++) {
+            m[col][j] *= scale;
+            inverse[col][j] *= scale;
+        }
+        for (int row = 0; row < n; row++) {
+            if (row == col || m[row][col] == 0.0)
+                continue;
+            double factor = m[row][col];
+            for (int j = 0; j < n; j++) {
+                m[row][j] -= factor * m[col][j];
+                inverse[row][j] -= factor * inverse[col][j];
+            }
+        }
+    }
+    m.swap(inverse);
+    return true;
+}
+
+struct Rating {
+    double elo;
+    double margin;   // Half-width of the 95% interval; 0 for the anchor, NaN if unknown
+};
+
+// Bradley-Terry fit by minorization-maximization (Hunter 2004), then the covariance of the
+// ratings from the inverse Fisher information with engine 0 held at 0.
+std::vector<Rating> fitRatings(int engines, const std::vector<Pairing>& pairings, const std::vector<PairResult>& results) {
+    std::vector<std::vector<double>> games(engines, std::vector<double>(engines, 0.0));
+    std::vector<double> points(engines, 0.0);
+    for (std::size_t p = 0; p < pairings.size(); p++) {
+        const PairResult& r = results[p];
+        if (r.games() == 0)
+            continue;
+        int a = pairings[p].first, b = pairings[p].second;
+        double n = r.games() + 1.0;  // Plus the virtual draw
+        games[a][b] += n;
+        games[b][a] += n;
+        points[a] += r.wins + 0.5 * r.draws + 0.5;
+        points[b] += r.losses + 0.5 * r.draws + 0.5;
+    }
+
+    std::vector<double> strength(engines, 1.0);
+    for (int iteration = 0; iteration < 10000; iteration++) {
+        double change = 0.0;
+        for (int i = 0; i < engines; i++) {
+            double denominator = 0.0;
+            for (int j = 0; j < engines; j++) {
+                if (j != i && games[i][j] > 0)
+                    denominator += games[i][j] / (strength[i] + strength[j]);
+            }
+            if (denominator <= 0)
+                continue;
+            double next = points[i] / denominator;
+            change = std::max(change, std::fabs(std::log(next / strength[i])));
+            strength[i] = next;
+        }
+        double anchor = strength[0];
+        for (auto &s : strength)
+            s /= anchor;
+        if (change < 1e-10)
+            break;
+    }
+
+    std::vector<Rating> ratings(engines);
+    for (int i = 0; i < engines; i++)
+        ratings[i] = Rating{std::log(strength[i]) * ELO_PER_NATURAL, i == 0 ? 0.0 : NAN};
+    if (engines < 2)
+        return ratings;
+    std::vector<std::vector<double>> information(engines - 1, std::vector<double>(engines - 1, 0.0));
+    for (int i = 1; i < engines; i++) {
+        for (int j = 0; j < engines; j++) {
+            if (j == i || games[i][j] <= 0)
+                continue;
+            double p = strength[i] / (strength[i] + strength[j]);
+            double w = games[i][j] * p * (1.0 - p);
+            information[i - 1][i - 1] += w;
+            if (j > 0)
+                information[i - 1][j - 1] -= w;
+        }
+    }
+    if (invert(information)) {
+        for (int i = 1; i < engines; i++)
+            ratings[i].margin = Z_95 * std::sqrt(std::max(0.0, information[i - 1][i - 1])) * ELO_PER_NATURAL;
+    }
+    return ratings;
+}
+
+template <class Board>
+struct Worker {
+    Worker(const Board& empty, std::size_t engines, std::size_t pairings, bool mctsNeeded)
+        : search(empty), times(engines), results(pairings), moves(0) {
+        if (mctsNeeded)
+            mcts.reset(new MctsEngine<Board>(MCTS_NODES, 1));
+    }
+
+    AlphaBetaSearch search;                    // Follows the game; used by greedy and alphabeta
+    std::unique_ptr<MctsEngine<Board>> mcts;
+    std::vector<int> empty;                    // Empty cells of the game in progress
+    std::vector<int> slot;                     // slot[cell]: index of 'cell' in 'empty'
+    std::uint64_t rng;
+    std::vector<MoveTimes> times;              // Per engine
+    std::vector<PairResult> results;           // Per pairing
+    std::uint64_t moves;
+
+    int randomCell() {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return empty[rng % empty.size()];
+    }
+    void removeEmpty(int cell) {
+        int last = empty.back();
+        empty[slot[cell]] = last;
+        slot[last] = slot[cell];
+        empty.pop_back();
+    }
+};
+
+template <class Board>
+class Tournament {
+public:
+    Tournament(const Board& emptyBoard, const Options& options, WorkStealingPool& pool)
+        : emptyBoard(emptyBoard), options(options), pool(pool) {
+        int count = static_cast<int>(options.engines.size());
+        for (int a = 0; a < count; a++) {
+            for (int b = a + 1; b < count; b++)
+                pairings.push_back(Pairing{a, b});
+        }
+    }
+
+    int run() {
+        int engineCount = static_cast<int>(options.engines.size());
+        int perPairing = options.games + options.games % 2;  // Openings are played in pairs
+        std::size_t total = pairings.size() * perPairing;
+        bool mctsNeeded = false;
+        for (const auto &engine : options.engines)
+            mctsNeeded = mctsNeeded || engine.kind == ENGINE_MCTS;
+        std::printf("Board: radius %d, %d in a row, %d cells  Engines: %d  Games: %zu (%d per pairing, %d random "
+                    "opening plies)  Threads: %d\n",
+                    options.radius, options.k, emptyBoard.cellCount(), engineCount, total, perPairing, options.opening,
+                    pool.size());
+        std::fflush(stdout);
+
+        std::vector<std::unique_ptr<Worker<Board>>> workers;
+        for (int i = 0; i < pool.size(); i++)
+            workers.emplace_back(new Worker<Board>(emptyBoard, engineCount, pairings.size(), mctsNeeded));
+
+        auto start = std::chrono::steady_clock::now();
+        pool.parallelFor(total, GAME_GRAIN, [&](std::size_t begin, std::size_t end, int worker) {
+            Worker<Board>& w = *workers[worker];
+            for (std::size_t game = begin; game < end; game++)
+                playGame(w, game);
+        });
+        double seconds = secondsSince(start);
+
+        std::vector<PairResult> results(pairings.size());
+        std::vector<MoveTimes> times(engineCount);
+        std::uint64_t moves = 0;
+        for (const auto &w : workers) {
+            for (std::size_t p = 0; p < pairings.size(); p++) {
+                results[p].wins += w->results[p].wins;
+                results[p].draws += w->results[p].draws;
+                results[p].losses += w->results[p].losses;
+            }
+            for (int e = 0; e < engineCount; e++)
+                times[e].merge(w->times[e]);
+            moves += w->moves;
+        }
+        std::printf("Played %zu games (%llu moves) in %.2f s: %.1f games/s, %.0f moves/s  Tasks stolen: %llu\n\n",
+                    total, static_cast<unsigned long long>(moves), seconds, total / seconds, moves / seconds,
+                    static_cast<unsigned long long>(pool.steals()));
+        report(results, times);
+        return 0;
+    }
+
+private:
+    // Game 2n and 2n + 1 share opening n, with the colours swapped; consecutive openings
+    // cycle through the pairings so every pairing progresses evenly.
+    void playGame(Worker<Board>& w, std::size_t game) {
+        std::size_t opening = game / 2;
+        const Pairing& pairing = pairings[opening % pairings.size()];
+        bool swapped = game % 2 == 1;
+        int sides[2] = {swapped ? pairing.second : pairing.first, swapped ? pairing.first : pairing.second};
+
+        std::uint64_t state = options.seed * 0x9E3779B97F4A7C15ULL + opening;
+        w.rng = splitMix64(state) | 1;
+        Board board = emptyBoard;
+        w.search.setPosition(board);
+        w.empty.resize(board.cellCount());
+        w.slot.resize(board.cellCount());
+        for (int cell = 0; cell < board.cellCount(); cell++)
+            w.empty[cell] = w.slot[cell] = cell;
+
+        char player = 'X';
+        char winner = ' ';
+        for (int ply = 0;; ply++) {
+            int cell;
+            if (ply < options.opening) {
+                cell = w.randomCell();
+            } else {
+                int engine = sides[ply % 2];
+                auto moveStart = std::chrono::steady_clock::now();
+                cell = chooseMove(w, options.engines[engine], board, player);
+                w.times[engine].add(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - moveStart).count()));
+            }
+            board.makeMoveAt(cell, player);
+            w.search.play(cell, player);
+            w.removeEmpty(cell);
+            w.moves++;
+            if (board.checkWinnerAt(cell) == player) {
+                winner = player;
+                break;
+            }
+            if (board.isFull())
+                break;
+            player = player == 'X' ? 'O' : 'X';
+        }
+
+        PairResult& result = w.results[opening % pairings.size()];
+        char firstMark = swapped ? 'O' : 'X';
+        if (winner == ' ')
+            result.draws++;
+        else if (winner == firstMark)
+            result.wins++;
+        else
+            result.losses++;
+    }
+
+    static int chooseMove(Worker<Board>& w, const EngineSpec& engine, const Board& board, char player) {
+        switch (engine.kind) {
+        case ENGINE_RANDOM:
+            return w.randomCell();
+        case ENGINE_GREEDY:
+        case ENGINE_ALPHABETA: {
+            int move = w.search.search(player, engine.depth).bestMove;
+            return move >= 0 ? move : w.randomCell();
+        }
+        case ENGINE_MCTS:
+            return w.mcts->search(board, player, engine.seconds);
+        }
+        return w.randomCell();
+    }
+
+    void report(const std::vector<PairResult>& results, const std::vector<MoveTimes>& times) const {
+        int engineCount = static_cast<int>(options.engines.size());
+        std::size_t width = 6;
+        for (const auto &engine : options.engines)
+            width = std::max(width, engine.name.size());
+        int w = static_cast<int>(width);
+
+        std::printf("%-*s  %-*s %7s %7s %7s %7s  %s\n", w, "Engine", w, "vs", "W", "D", "L", "Score",
+                    "Elo diff (95%)");
+        for (std::size_t p = 0; p < pairings.size(); p++) {
+            const PairResult& r = results[p];
+            double n = static_cast<double>(r.games());
+            double s = r.score();
+            // Wilson interval on the score, with the variance of one game's score taken from the
+            // observed win / draw / loss frequencies; unlike s +/- margin it stays inside (0, 1)
+            // for lopsided pairings.
+            double variance = n > 0 ? (r.wins * (1 - s) * (1 - s) + r.draws * (0.5 - s) * (0.5 - s) + r.losses * s * s) / n : 0;
+            double z2n = n > 0 ? Z_95 * Z_95 / n : 0;
+            double centre = (s + z2n / 2) / (1 + z2n);
+            double margin = n > 0 ? Z_95 / (1 + z2n) * std::sqrt(variance / n + z2n / (4 * n)) : 0;
+            std::printf("%-*s  %-*s %7llu %7llu %7llu %6.1f%%  %s [%s, %s]\n", w, options.engines[pairings[p].first].name.c_str(),
+                        w, options.engines[pairings[p].second].name.c_str(), static_cast<unsigned long long>(r.wins),
+                        static_cast<unsigned long long>(r.draws), static_cast<unsigned long long>(r.losses), s * 100,
+                        formatElo(eloFromScore(s)).c_str(), formatElo(eloFromScore(centre - margin)).c_str(),
+                        formatElo(eloFromScore(centre + margin)).c_str());
+        }
+
+        std::vector<Rating> ratings = fitRatings(engineCount, pairings, results);
+        std::vector<int> order(engineCount);
+        for (int e = 0; e < engineCount; e++)
+            order[e] = e;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return ratings[a].elo > ratings[b].elo; });
+        std::printf("\n%4s  %-*s %7s  %-9s %8s %7s\n", "Rank", w, "Engine", "Elo", "95%", "Games", "Score");
+        for (int rank = 0; rank < engineCount; rank++) {
+            int e = order[rank];
+            double games = 0, points = 0;
+            for (std::size_t p = 0; p < pairings.size(); p++) {
+                const PairResult& r = results[p];
+                if (pairings[p].first == e) {
+                    games += r.games();
+                    points += r.wins + 0.5 * r.draws;
+                } else if (pairings[p].second == e) {
+                    games += r.games();
+                    points += r.losses + 0.5 * r.draws;
+                }
+            }
+            char margin[16];
+            if (e == 0)
+                std::snprintf(margin, sizeof(margin), "anchor");
+            else if (std::isnan(ratings[e].margin))
+                std::snprintf(margin, sizeof(margin), "?");
+            else
+                std::snprintf(margin, sizeof(margin), "+/- %.0f", ratings[e].margin);
+            std::printf("%4d  %-*s %7s  %-9s %8.0f %6.1f%%\n", rank + 1, w, options.engines[e].name.c_str(),
+                        formatElo(ratings[e].elo).c_str(), margin, games, games > 0 ? points / games * 100 : 0.0);
+        }
+
+        std::printf("\n%-*s %10s %10s %10s %10s %10s %10s\n", w, "Time per move", "Moves", "Mean", "p50", "p90", "p99",
+                    "Max");
+        for (int e = 0; e < engineCount; e++) {
+            const MoveTimes& t = times[e];
+            std::printf("%-*s %10llu %10s %10s %10s %10s %10s\n", w, options.engines[e].name.c_str(),
+                        static_cast<unsigned long long>(t.count()), formatNanos(t.meanNanos()).c_str(),
+                        formatNanos(t.percentile(0.50)).c_str(), formatNanos(t.percentile(0.90)).c_str(),
+                        formatNanos(t.percentile(0.99)).c_str(), formatNanos(static_cast<double>(t.maximum())).c_str());
+        }
+    }
+
+    Board emptyBoard;
+    const Options& options;
+    WorkStealingPool& pool;
+    std::vector<Pairing> pairings;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        std::string arg = argv[i];
+        EngineSpec engine;
+        if (arg == "--engine" && i + 1 < argc) {
+            usage = !parseEngine(argv[++i], engine);
+            options.engines.push_back(engine);
+        } else if (arg == "--games" && i + 1 < argc) {
+            options.games = std::atoi(argv[++i]);
+        } else if (arg == "--radius" && i + 1 < argc) {
+            options.radius = std::atoi(argv[++i]);
+        } else if (arg == "--k" && i + 1 < argc) {
+            options.k = std::atoi(argv[++i]);
+        } else if (arg == "--opening" && i + 1 < argc) {
+            options.opening = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            usage = true;
+        }
+    }
+    if (options.engines.empty()) {
+        for (const char* name : DEFAULT_ENGINES) {
+            EngineSpec engine;
+            parseEngine(name, engine);
+            options.engines.push_back(engine);
+        }
+    }
+    if (usage || options.engines.size() < 2 || options.games < 1 || options.radius < 0 ||
+        options.radius > MAX_BOARD_RADIUS || options.k < 1 || options.opening < 0) {
+        std::cerr << "Usage: hex_tournament [--engine SPEC]... [--games N] [--radius R] [--k K] [--opening N]\n"
+                  << "                      [--threads N] [--seed S]\n"
+                  << "  SPEC: random | greedy | alphabeta:DEPTH | mcts:SECONDS (at least two engines)" << std::endl;
+        return 1;
+    }
+
+    WorkStealingPool pool(options.threads);
+    return withHexBoard(options.radius, options.k, [&](const auto& empty) {
+        typedef typename std::decay<decltype(empty)>::type Board;
+        Tournament<Board> tournament(empty, options, pool);
+        return tournament.run();
+    });
+}
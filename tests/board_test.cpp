@@ -0,0 +1,186 @@
+// --- board_test.cpp ---
+// Differential test of the incremental rules against full scans. Every game on the radius-1
+// boards, and every opening of PREFIX_PLIES moves on the game board (each finished with a
+// pseudo-random playout), is played on HexBoard and DynamicHexBoard. After each move,
+// checkWinnerAt()/checkWinnerAfter() must agree with checkWinner() and with a scan of the
+// cells, and isFull()/moveCount()/valueAt() with the marks actually placed.
+//
+// Usage: hex_board_test        (exit status 0 if every check passes)
+
+#include "HexBoard.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const int PREFIX_PLIES = 4;   // Exhaustive plies on the 19-cell board
+
+struct Tally {
+    std::uint64_t positions = 0;
+    std::uint64_t wins = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t failures = 0;
+};
+
+// Winner by walking every cell and direction of 'values', independent of the board's tables.
+template <class Board>
+char scanWinner(const Board& board, const std::vector<char>& values) {
+    int k = board.winLength();
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        char mark = values[cell];
+        if (mark == ' ')
+            continue;
+        HexCell c = board.cellAt(cell);
+        for (int d = 0; d < 6; d++) {
+            int run = 1;
+            while (run < k) {
+                int next = board.cellIndex(c.q + run * HEX_DIRECTIONS[d][0], c.r + run * HEX_DIRECTIONS[d][1]);
+                if (next < 0 || values[next] != mark)
+                    break;
+                run++;
+            }
+            if (run == k)
+                return mark;
+        }
+    }
+    return ' ';
+}
+
+// One game driven in lockstep on a compile-time and a runtime board of the same size.
+template <class Board>
+class Checker {
+public:
+    Checker(const char* name, const Board& empty, Tally& tally)
+        : name(name), board(empty), dynamic(empty.radius(), empty.winLength()),
+          values(empty.cellCount(), ' '), tally(tally) {}
+
+    // Plays 'cell' for 'player' and checks both boards. Returns the winner, or ' '.
+    char play(int cell, char player) {
+        Board beforeBoard = board;
+        DynamicHexBoard beforeDynamic = dynamic;
+        bool placed = board.makeMoveAt(cell, player) && dynamic.makeMoveAt(cell, player);
+        values[cell] = player;
+        moves.push_back(cell);
+        tally.positions++;
+
+        char scanned = scanWinner(board, values);
+        HexCell c = board.cellAt(cell);
+        int count = 0;
+        bool cellsMatch = true;
+        for (int i = 0; i < board.cellCount(); i++) {
+            count += values[i] != ' ';
+            cellsMatch = cellsMatch && board.valueAt(i) == values[i] && dynamic.valueAt(i) == values[i];
+        }
+        bool full = count == board.cellCount();
+        check(placed, "move rejected");
+        check(board.checkWinner() == scanned && dynamic.checkWinner() == scanned, "checkWinner() differs from the scan");
+        check(board.checkWinnerAt(cell) == scanned && dynamic.checkWinnerAt(cell) == scanned, "checkWinnerAt() differs");
+        check(board.checkWinnerAfter(c.q, c.r) == scanned && dynamic.checkWinnerAfter(c.q, c.r) == scanned,
+              "checkWinnerAfter() differs");
+        check(board.isFull() == full && dynamic.isFull() == full, "isFull() differs");
+        check(board.moveCount() == count && dynamic.moveCount() == count, "moveCount() differs");
+        check(cellsMatch, "valueAt() differs");
+        check(!board.makeMoveAt(cell, player) && !dynamic.makeMoveAt(cell, player), "occupied cell accepted");
+
+        if (scanned != ' ')
+            tally.wins++;
+        else if (full)
+            tally.draws++;
+        saved.push_back(Saved{beforeBoard, beforeDynamic});
+        return scanned;
+    }
+
+    void undo() {
+        board = saved.back().board;
+        dynamic = saved.back().dynamic;
+        saved.pop_back();
+        values[moves.back()] = ' ';
+        moves.pop_back();
+    }
+
+    const Board& current() const { return board; }
+
+private:
+    struct Saved {
+        Board board;
+        DynamicHexBoard dynamic;
+    };
+
+    void check(bool ok, const char* what) {
+        if (ok)
+            return;
+        if (tally.failures++ < 10) {
+            std::printf("FAIL %s: %s after moves", name, what);
+            for (int move : moves)
+                std::printf(" %d", move);
+            std::printf("\n");
+        }
+    }
+
+    const char* name;
+    Board board;
+    DynamicHexBoard dynamic;
+    std::vector<char> values;
+    std::vector<int> moves;
+    std::vector<Saved> saved;
+    Tally& tally;
+};
+
+// Every move order until a win or a full board, below 'limit' plies; past it, one
+// pseudo-random continuation to the end.
+template <class Board>
+void enumerate(Checker<Board>& checker, char player, int ply, int limit, std::uint64_t& rng) {
+    const Board& board = checker.current();
+    char next = player == 'X' ? 'O' : 'X';
+    if (ply >= limit) {
+        int played = 0;
+        for (;;) {
+            std::vector<int> empty;
+            for (int cell = 0; cell < board.cellCount(); cell++) {
+                if (board.valueAt(cell) == ' ')
+                    empty.push_back(cell);
+            }
+            if (empty.empty())
+                break;
+            rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            char mover = (ply + played) % 2 == 0 ? 'X' : 'O';
+            played++;
+            if (checker.play(empty[(rng >> 33) % empty.size()], mover) != ' ')
+                break;
+        }
+        while (played-- > 0)
+            checker.undo();
+        return;
+    }
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        if (board.valueAt(cell) != ' ')
+            continue;
+        char winner = checker.play(cell, player);
+        if (winner == ' ' && !checker.current().isFull())
+            enumerate(checker, next, ply + 1, limit, rng);
+        checker.undo();
+    }
+}
+
+template <class Board>
+bool run(const char* name, int limit) {
+    Tally tally;
+    Checker<Board> checker(name, Board(), tally);
+    std::uint64_t rng = 0x6865787474740003ULL;
+    enumerate(checker, 'X', 0, limit, rng);
+    std::printf("%-26s %10llu positions %9llu wins %9llu draws  %s\n", name,
+                static_cast<unsigned long long>(tally.positions), static_cast<unsigned long long>(tally.wins),
+                static_cast<unsigned long long>(tally.draws), tally.failures ? "FAILED" : "ok");
+    return tally.failures == 0;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok = run<HexBoard<1, 2>>("radius 1, k 2 (all games)", 1 << 30) && ok;
+    ok = run<HexBoard<1, 3>>("radius 1, k 3 (all games)", 1 << 30) && ok;
+    ok = run<GameBoard>("radius 2, k 3 (4-ply prefix)", PREFIX_PLIES) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// --- record_test.cpp ---
+// Appending to a game archive that an interrupted writer left incomplete. The archive is cut
+// inside its last block, and inside its header, before GameRecordWriter appends more games;
+// GameArchive must then read every complete game, old and new, with nothing flagged as
+// truncated. A file that is not an archive must be refused and left untouched.
+//
+// Usage: hex_record_test        (exit status 0 if every check passes; writes record_test.hxgr
+//                                in the working directory and removes it)
+
+#include "GameRecord.h"
+#include "HexBoard.h"
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char* const ARCHIVE_PATH = "record_test.hxgr";
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+// Writes 'games' games of 'moves' moves each, every one in its own block.
+bool appendGames(int games, int moves) {
+    GameRecordWriter writer(ARCHIVE_PATH);
+    for (int i = 0; i < games; i++) {
+        std::vector<int> cells;
+        for (int m = 0; m < moves; m++)
+            cells.push_back((i + m) % GameBoard::CELL_COUNT);
+        if (!writer.append(BOARD_RADIUS, WIN_LENGTH, RESULT_UNFINISHED, cells) || !writer.flush())
+            return false;
+    }
+    return writer.good();
+}
+
+long fileSize() {
+    std::FILE* file = std::fopen(ARCHIVE_PATH, "rb");
+    if (!file)
+        return -1;
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    return size;
+}
+
+// Games in the archive with the given move count, or -1 if it cannot be read cleanly.
+int countGames(int moves) {
+    GameArchive archive;
+    std::string error;
+    if (!archive.open(ARCHIVE_PATH, error)) {
+        std::printf("  %s\n", error.c_str());
+        return -1;
+    }
+    if (archive.truncated())
+        return -1;
+    int games = 0;
+    for (const GameBlock& block : archive.blocks()) {
+        const std::uint8_t* data = block.data;
+        const std::uint8_t* end = block.data + block.bytes;
+        for (std::uint32_t i = 0; i < block.records; i++) {
+            GameRecordView record;
+            if (!readGameRecord(data, end, record))
+                return -1;
+            games += record.moveCount == moves;
+        }
+    }
+    return games;
+}
+
+} // namespace
+
+int main() {
+    std::remove(ARCHIVE_PATH);
+    check(appendGames(2, 4), "writing a new archive");
+    check(countGames(4) == 2, "new archive reads back");
+
+    // Killed inside the last block: that game is lost, the games appended after it are not.
+    check(::truncate(ARCHIVE_PATH, fileSize() - 3) == 0, "truncating the archive");
+    check(appendGames(3, 6), "appending after a partial block");
+    check(countGames(4) == 1 && countGames(6) == 3, "games appended after a partial block read back");
+
+    // Killed inside the header of the last block (a game of 6 moves): 3 of its bytes are left.
+    long lastBlock = static_cast<long>(GAME_BLOCK_HEADER_BYTES + GAME_RECORD_HEADER_BYTES) + 6;
+    check(::truncate(ARCHIVE_PATH, fileSize() - lastBlock + 3) == 0, "truncating the archive");
+    check(appendGames(1, 7), "appending after a partial block header");
+    check(countGames(6) == 2 && countGames(7) == 1, "games appended after a partial block header read back");
+
+    // Killed inside the archive header.
+    check(::truncate(ARCHIVE_PATH, 3) == 0, "truncating the archive");
+    check(appendGames(2, 5), "appending after a partial archive header");
+    check(countGames(5) == 2 && countGames(4) == 0, "games appended after a partial archive header read back");
+
+    // Not an archive: refused, and not cut.
+    std::FILE* other = std::fopen(ARCHIVE_PATH, "wb");
+    std::fputs("not a game archive at all", other);
+    std::fclose(other);
+    long size = fileSize();
+    check(!appendGames(1, 4), "appending to a file that is not an archive fails");
+    check(fileSize() == size, "a file that is not an archive is left alone");
+
+    std::remove(ARCHIVE_PATH);
+    std::printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}